@@ -0,0 +1,97 @@
+#
+# notes2zeal(
+#   <target>
+#   [VERBOSE]
+#   [SPEED <ticks-per-row>]
+#   [ROWS <rows-per-pattern>]
+#   [LOOP <order-entry>]
+#   [TRACK <midi-track>]
+#   [OUTPUT <output-path>]
+#   FILES <notes> [<notes>...]
+# )
+# <target>: Existing CMake target that will depend on the generated songs.
+# VERBOSE: Enable verbose output from the conversion script.
+# SPEED <ticks-per-row>: Number of frames per row of the song.
+# ROWS <rows-per-pattern>: Number of rows per pattern.
+# LOOP <order-entry>: Order entry to loop to at the end of the song.
+# TRACK <midi-track>: Track to convert when the input is a MIDI file.
+# OUTPUT <output-path>: Write the generated `.zsq` to a specific path.
+# FILES <notes> [<notes>...]: One or more notes.txt or MIDI files to convert.
+function(notes2zeal target)
+    set(target_name ${ARGV0})
+    # Remove target name for parsing
+    list(REMOVE_AT ARGV 0)
+
+    # Parse arguments
+    set(_FLAGS VERBOSE)
+    set(_KEYS SPEED ROWS LOOP TRACK OUTPUT)
+
+    cmake_parse_arguments(
+        NOTES2ZEAL
+        "${_FLAGS}"
+        "${_KEYS}"
+        FILES
+        ${ARGV}
+    )
+
+    set(extra_args_list "")
+    if(NOTES2ZEAL_VERBOSE)
+        list(APPEND extra_args_list "-v")
+    endif()
+    if(NOTES2ZEAL_SPEED)
+        list(APPEND extra_args_list "-s" "${NOTES2ZEAL_SPEED}")
+    endif()
+    if(NOTES2ZEAL_ROWS)
+        list(APPEND extra_args_list "-r" "${NOTES2ZEAL_ROWS}")
+    endif()
+    if(DEFINED NOTES2ZEAL_LOOP)
+        list(APPEND extra_args_list "-l" "${NOTES2ZEAL_LOOP}")
+    endif()
+    if(DEFINED NOTES2ZEAL_TRACK)
+        list(APPEND extra_args_list "-t" "${NOTES2ZEAL_TRACK}")
+    endif()
+
+    if(NOTES2ZEAL_OUTPUT)
+        list(LENGTH NOTES2ZEAL_FILES notes2zeal_file_count)
+        if(notes2zeal_file_count GREATER 1)
+            message(FATAL_ERROR "notes2zeal OUTPUT can only be used with one input file")
+        endif()
+    endif()
+
+    foreach(notes ${NOTES2ZEAL_FILES})
+        get_filename_component(fname_we ${notes} NAME_WE)
+        get_filename_component(notes_abs ${notes} ABSOLUTE)
+        string(REPLACE "." "_" fname_safe ${fname_we})
+
+        if(NOTES2ZEAL_OUTPUT)
+            if(IS_ABSOLUTE "${NOTES2ZEAL_OUTPUT}")
+                set(output_path "${NOTES2ZEAL_OUTPUT}")
+            else()
+                set(output_path "${CMAKE_BINARY_DIR}/${NOTES2ZEAL_OUTPUT}")
+            endif()
+        else()
+            set(output_path "${CMAKE_BINARY_DIR}/assets/${fname_we}.zsq")
+        endif()
+
+        set(stamp ${CMAKE_BINARY_DIR}/CMakeFiles/${target}_${fname_safe}_song_asset.stamp)
+
+        # Make a unique target name based on the input filename
+        set(custom_target_name "${target}_${fname_safe}_song_asset")
+
+        add_custom_command(
+            OUTPUT ${stamp} ${output_path}
+            COMMAND ${Python3_EXECUTABLE} $ENV{ZVB_SDK_PATH}/tools/notes2zeal/notes2zeal.py
+                    -i ${notes_abs}
+                    -o ${output_path}
+                    ${extra_args_list}
+            COMMAND ${CMAKE_COMMAND} -E touch ${stamp}
+            DEPENDS ${notes_abs} $ENV{ZVB_SDK_PATH}/tools/notes2zeal/notes2zeal.py
+            COMMENT "Compiling song ${fname_we}"
+            VERBATIM
+        )
+
+        # Per-file custom target
+        add_custom_target(${custom_target_name} ALL DEPENDS ${stamp})
+        add_dependencies(${target_name} ${custom_target_name})
+    endforeach()
+endfunction()
@@ -3,4 +3,5 @@ if (NOT DEFINED ZVB_SDK_DIR)
 endif()
 
 include(${CMAKE_CURRENT_LIST_DIR}/tiled2zeal.cmake)
-include(${CMAKE_CURRENT_LIST_DIR}/gif2zeal.cmake)
\ No newline at end of file
+include(${CMAKE_CURRENT_LIST_DIR}/gif2zeal.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/notes2zeal.cmake)
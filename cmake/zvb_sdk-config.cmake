@@ -1,6 +1,6 @@
 # Called by: find_package(ZVB REQUIRED)
 
-set(libraries zvb_crc zvb_dma zvb_gfx zvb_sound)
+set(libraries zvb_crc zvb_dma zvb_gfx zvb_sound zvb_spi zvb_text)
 
 foreach(lib ${libraries})
     add_library(${lib} INTERFACE IMPORTED)
@@ -11,3 +11,6 @@ foreach(lib ${libraries})
         INTERFACE_LINK_DIRECTORIES "${CMAKE_CURRENT_LIST_DIR}/../lib"
     )
 endforeach()
+
+# The DMA library relies on the CRC library to calibrate the controller
+set_target_properties(zvb_dma PROPERTIES INTERFACE_LINK_LIBRARIES zvb_crc)
@@ -0,0 +1,135 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <zos_sys.h>
+#include <zvb_hardware.h>
+#include <zvb_sound.h>
+#include <zvb_sound_mix.h>
+
+/* The raster counters run at the VGA pixel clock, 800 ticks per line, 525 lines per frame */
+#define RASTER_LINE_TICKS   800UL
+#define RASTER_FRAME_TICKS  (RASTER_LINE_TICKS * 525)
+#define PIXEL_CLOCK_KHZ     25175UL
+#define CPU_CLOCK_KHZ       10000UL
+#define SOUND_CLOCK_HZ      44091UL
+
+#define BENCH_RUNS          8
+
+static uint8_t s_tone_low[MIX_CHUNK_SIZE];
+static uint8_t s_tone_high[MIX_CHUNK_SIZE];
+static uint8_t s_output[MIX_CHUNK_SIZE];
+static uint8_t s_ring[2 * MIX_CHUNK_SIZE];
+
+
+static uint32_t raster_ticks(void)
+{
+    /* Reading the LSB latches the MSB */
+    const uint8_t vlow = zvb_ctrl_vpos_low;
+    const uint16_t vpos = (zvb_ctrl_vpos_high << 8) | vlow;
+    const uint8_t hlow = zvb_ctrl_hpos_low;
+    const uint16_t hpos = (zvb_ctrl_hpos_high << 8) | hlow;
+    return vpos * RASTER_LINE_TICKS + hpos;
+}
+
+
+static uint32_t raster_elapsed(uint32_t start)
+{
+    const uint32_t now = raster_ticks();
+    return (now >= start) ? now - start : now + RASTER_FRAME_TICKS - start;
+}
+
+
+/**
+ * @brief Generate a square wave with the given period, in samples
+ */
+static void generate_tone(uint8_t* samples, uint8_t period)
+{
+    for (uint8_t i = 0; i < MIX_CHUNK_SIZE; i++) {
+        samples[i] = ((i % period) < period / 2) ? 0xc0 : 0x40;
+    }
+}
+
+
+static void play_tones(uint8_t channels)
+{
+    const zvb_mix_sfx_t low = { s_tone_low, MIX_CHUNK_SIZE, 1, 0 };
+    const zvb_mix_sfx_t high = { s_tone_high, MIX_CHUNK_SIZE, 1, 0 };
+    for (uint8_t i = 0; i < channels; i++) {
+        zvb_sound_mix_play((i & 1) ? &high : &low);
+    }
+}
+
+
+/**
+ * @brief Measure the average number of T-states needed to mix one sample with the given
+ *        number of active channels
+ */
+static uint16_t bench_channels(uint8_t channels)
+{
+    uint32_t total = 0;
+
+    for (uint8_t run = 0; run < BENCH_RUNS; run++) {
+        play_tones(channels);
+        const uint32_t start = raster_ticks();
+        zvb_sound_mix_render(s_output, MIX_CHUNK_SIZE);
+        total += raster_elapsed(start);
+    }
+
+    /* Convert the pixel clocks into CPU T-states */
+    return (total * CPU_CLOCK_KHZ / PIXEL_CLOCK_KHZ) / (BENCH_RUNS * MIX_CHUNK_SIZE);
+}
+
+
+/**
+ * @brief Percentage of the CPU time spent mixing at the given sample rate divider
+ */
+static uint16_t cpu_load(uint16_t tstates, uint8_t divider)
+{
+    const uint32_t rate = SOUND_CLOCK_HZ / (divider + 1);
+    return (uint32_t) tstates * rate / (CPU_CLOCK_KHZ * 10);
+}
+
+
+int main(void)
+{
+    generate_tone(s_tone_low, 64);
+    generate_tone(s_tone_high, 16);
+
+    zvb_sound_initialize(1);
+    zvb_sound_set_channels(SAMPTAB, SAMPTAB);
+
+    /* The mixer is started with the maximum number of channels, the playback is never serviced
+     * during the benchmark, only the rendering is measured */
+    zvb_sound_mix_start(MIX_CHANNELS, 3, s_ring, sizeof(s_ring));
+
+    printf("channels  T-states/sample  11kHz (div 3)  22kHz (div 1)\n");
+    for (uint8_t channels = 1; channels <= MIX_CHANNELS; channels++) {
+        const uint16_t tstates = bench_channels(channels);
+        printf("%d         %d              %d%%            %d%%\n",
+               channels, tstates, cpu_load(tstates, 3), cpu_load(tstates, 1));
+    }
+    zvb_sound_async_stop();
+
+    /* Play both tones on top of each other for a while, at ~11kHz */
+    zvb_sound_set_volume(VOL_100);
+    zvb_sound_mix_start(2, 3, s_ring, sizeof(s_ring));
+    for (uint8_t i = 0; i < 64; i++) {
+        play_tones(2);
+        while (zvb_sound_mix_active()) {
+            zvb_sound_mix_service();
+        }
+    }
+    /* Let the FIFO drain before stopping */
+    zvb_sound_async_end();
+    while (zvb_sound_async_status() != SOUND_ASYNC_STOPPED) {
+        zvb_sound_service();
+    }
+    zvb_sound_set_volume(VOL_0);
+
+    return 0;
+}
@@ -9,6 +9,7 @@
 #include <zos_sys.h>
 #include <zos_vfs.h>
 #include <zvb_sound.h>
+#include <zvb_sound_stream.h>
 
 /**
  * These symbols are in fact defined in the inline assembly code in `_sample_raw` function.
@@ -17,9 +18,26 @@
 extern uint8_t _sample_end;
 extern uint8_t _sample_start;
 
+/**
+ * @brief Stream the given raw or WAV file instead of the embedded sample
+ */
+static int play_file(const char* name, sound_samples_conf_t* config)
+{
+    zos_dev_t fd = open(name, O_RDONLY);
+    if (fd < 0) {
+        printf("Error opening file %s\n", name);
+        return 1;
+    }
+    zos_err_t err = zvb_sound_stream_file(fd, config);
+    close(fd);
+    if (err != ERR_SUCCESS) {
+        printf("Error playing file %s: %d\n", name, err);
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char** argv) {
-    (void) argc;
-    (void) argv;
     /* Initialize the sound controller and reset it */
     zvb_sound_initialize(1);
     /* Assign the sample table to both channels */
@@ -34,6 +52,14 @@ int main(int argc, char** argv) {
         .divider = 3
     };
 
+    /* On Zeal 8-bit OS, the parameters are not split, argv[0] contains the file name.
+     * Raw files are expected to have the same format as the embedded sample */
+    if (argc == 1) {
+        const int ret = play_file(argv[0], &config);
+        zvb_sound_set_volume(VOL_0);
+        return ret;
+    }
+
     /* SDCC doesn't let us easily include a binary file, so use the
      * `_sample_raw` function for that */
     const size_t sample_size = &_sample_end - &_sample_start;
@@ -8,7 +8,7 @@
 #include <stdint.h>
 #include <zos_sys.h>
 #include <zos_vfs.h>
-#include <zvb_crc.h>
+#include <zvb_crc_file.h>
 
 static char* split_string(char* current, char** next)
 {
@@ -27,12 +27,11 @@ static char* split_string(char* current, char** next)
 }
 
 
-static uint32_t calculate_file_crc32(const char* name)
+static uint32_t calculate_file_crc32(const char* name, zvb_crc_stats_t* stats)
 {
-    zos_err_t err;
-    uint16_t size;
-    /* Use static memory to avoid stack allocations */
-    static uint8_t buf[1024];
+    uint32_t crc32;
+    /* Use static memory to avoid stack allocations, the bigger the buffer, the faster */
+    static uint8_t buf[16384];
 
     zos_dev_t fd = open(name, O_RDONLY);
     if (fd < 0) {
@@ -40,20 +39,12 @@ static uint32_t calculate_file_crc32(const char* name)
         exit(1);
     }
 
-    zvb_crc_initialize(1);
-    while (1) {
-        size = sizeof(buf);
-        err = read(fd, buf, &size);
-        if (err != ERR_SUCCESS) {
-            printf("Error reading file %s\n", name);
-            exit(1);
-        }
-        if (size == 0) {
-            break;
-        }
-        zvb_crc_update(buf, size);
+    if (zvb_crc_file(fd, buf, sizeof(buf), &crc32, stats) != ERR_SUCCESS) {
+        printf("Error reading file %s\n", name);
+        exit(1);
     }
-    return zvb_crc_update(NULL, 0);
+    close(fd);
+    return crc32;
 }
 
 
@@ -68,8 +59,9 @@ int main(int argc, char** argv) {
     char* next = NULL;
     char* name = split_string(argv[0], &next);
     while (name) {
-        const uint32_t crc32 = calculate_file_crc32(name);
-        printf("%08lx    %s\n", crc32, name);
+        zvb_crc_stats_t stats;
+        const uint32_t crc32 = calculate_file_crc32(name, &stats);
+        printf("%08lx    %s    %lu bytes, %lu bytes/s\n", crc32, name, stats.bytes, stats.rate);
         name = split_string(next, &next);
     }
 
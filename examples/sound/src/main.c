@@ -8,7 +8,9 @@
 #include <stdint.h>
 #include <zos_sys.h>
 #include <zos_vfs.h>
+#include <zvb_hardware.h>
 #include <zvb_sound.h>
+#include <zvb_sound_seq.h>
 #include "piano.h"
 
 #define BPM         400
@@ -38,6 +40,44 @@ static char* split_string(char* current, char** next)
 }
 
 
+/* Songs compiled with `tools/notes2zeal` are loaded as-is */
+static uint8_t song[4096];
+
+static zos_err_t play_song(const char* filename)
+{
+    zos_dev_t fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -fd;
+    }
+    uint16_t size = sizeof(song);
+    zos_err_t err = read(fd, song, &size);
+    close(fd);
+    if (err != ERR_SUCCESS) {
+        return err;
+    }
+
+    if (size < SEQ_HEADER_SIZE || zvb_sound_seq_play(song) != SEQ_SUCCESS) {
+        return ERR_INVALID_PARAMETER;
+    }
+
+    zvb_sound_set_channels(VOICE0 | VOICE1 | VOICE2 | VOICE3, VOICE0 | VOICE1 | VOICE2 | VOICE3);
+    zvb_sound_set_voices_vol(VOICE0 | VOICE1 | VOICE2 | VOICE3, VOL_100);
+    zvb_sound_set_volume(VOL_100);
+
+    /* One tick per frame */
+    while (zvb_sound_seq_playing()) {
+        while ((zvb_ctrl_status & (1 << ZVB_CTRL_STATUS_VBLANK_BIT)) == 0) {
+        }
+        zvb_sound_seq_tick();
+        while (zvb_ctrl_status & (1 << ZVB_CTRL_STATUS_VBLANK_BIT)) {
+        }
+    }
+
+    zvb_sound_set_volume(VOL_0);
+    return ERR_SUCCESS;
+}
+
+
 int main(int argc, char** argv) {
     char* next;
 
@@ -53,6 +93,12 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    /* Try to play the file as a compiled song first, fallback to the text format */
+    zvb_sound_initialize(1);
+    if (play_song(filename) == ERR_SUCCESS) {
+        return 0;
+    }
+
     zos_err_t ret = parse_notes_file(filename);
     if (ret != 0) {
         printf("Error parsing file\n");
@@ -60,7 +106,6 @@ int main(int argc, char** argv) {
     }
 
     /* The file has been parsed and the table partition has been filled */
-    zvb_sound_initialize(1);
     zvb_sound_set_voices(VOICE0, 0, note_waveform);
     /* Assign the channel to the left and right channels even if `initialize`
      * may have done it already. */
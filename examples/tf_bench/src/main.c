@@ -0,0 +1,122 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <zos_sys.h>
+#include <zos_time.h>
+#include <zvb_tf.h>
+
+/* Each measurement reads BENCH_READS times BENCH_BLOCKS blocks, 64KB in total */
+#define BENCH_BLOCKS    8
+#define BENCH_READS     16
+#define BENCH_BYTES     ((uint32_t) BENCH_READS * BENCH_BLOCKS * TF_BLOCK_SIZE)
+
+/* Dividers to measure, from the slowest to the fastest */
+static const uint8_t s_dividers[] = { SPI_CLK_DIV_SLOW, 25, 12, 8, 6, 5, 4, 3, 2, 1 };
+
+static uint8_t s_buffer[BENCH_BLOCKS * TF_BLOCK_SIZE];
+
+
+static uint32_t parse_block(const char* str)
+{
+    uint32_t value = 0;
+    while (*str >= '0' && *str <= '9') {
+        value = value * 10 + (*str - '0');
+        str++;
+    }
+    return value;
+}
+
+
+/**
+ * @brief Get the current time in milliseconds, 0 if the target doesn't have a timer
+ */
+static uint16_t millis(void)
+{
+    zos_time_t time;
+
+    if (gettime(0, &time) != ERR_SUCCESS) {
+        return 0;
+    }
+    return time.t_millis;
+}
+
+
+/**
+ * @brief Read BENCH_BYTES from the card with multi-block reads, with or without the CRC check
+ *
+ * @param ms Filled with the duration of the reads
+ */
+static tf_error bench_reads(uint32_t block, uint8_t crc, uint16_t* ms)
+{
+    tf_error err = zvb_tf_set_crc(crc);
+    if (err) {
+        return err;
+    }
+
+    const uint16_t start = millis();
+    for (uint8_t i = 0; i < BENCH_READS && err == TF_SUCCESS; i++) {
+        err = zvb_tf_read(block + i * BENCH_BLOCKS, s_buffer, BENCH_BLOCKS);
+    }
+    *ms = millis() - start;
+    return err;
+}
+
+
+static uint32_t rate_kbs(uint16_t ms)
+{
+    return ms == 0 ? 0 : (BENCH_BYTES * 1000 / 1024) / ms;
+}
+
+
+int main(int argc, char** argv)
+{
+    uint32_t block = 0;
+
+    /* On Zeal 8-bit OS, the argc is either 0 or 1, the strings are not split */
+    if (argc == 1) {
+        block = parse_block(argv[0]);
+    }
+
+    tf_error err = zvb_tf_init();
+    if (err) {
+        printf("Could not initialize the TF card: error %d\n", err);
+        return 1;
+    }
+
+    printf("Reading %lu bytes from block %lu\n", BENCH_BYTES, block);
+    printf(" div    kHz   KB/s  KB/s (CRC)\n");
+    for (uint8_t i = 0; i < sizeof(s_dividers); i++) {
+        const uint8_t div = s_dividers[i];
+        uint16_t ms = 0;
+        uint16_t crc_ms = 0;
+
+        zvb_spi_set_clk_div(div);
+        printf("%4d %6lu ", div, 25000UL / div);
+        err = bench_reads(block, 0, &ms);
+        if (err == TF_SUCCESS) {
+            err = bench_reads(block, 1, &crc_ms);
+        }
+        if (err) {
+            printf("error %d\n", err);
+            /* Go back to a safe speed, the card may need it to accept the next commands */
+            zvb_spi_set_clk_div(SPI_CLK_DIV_SLOW);
+            zvb_tf_set_crc(0);
+            continue;
+        }
+        printf("%6lu  %6lu\n", rate_kbs(ms), rate_kbs(crc_ms));
+    }
+
+    uint8_t best;
+    err = zvb_tf_negotiate_clock(block, s_buffer, &best);
+    if (err) {
+        printf("Clock negotiation failed: error %d\n", err);
+        return 1;
+    }
+    printf("Fastest reliable divider: %d (%lu kHz)\n", best, 25000UL / best);
+    return 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <zos_sys.h>
+#include <zos_vfs.h>
+#include <zos_video.h>
+#include <zvb_hardware.h>
+#include <zvb_gfx.h>
+#include <zvb_tf.h>
+#include "video.h"
+
+/* Maximum number of blocks read from the card between two checks of the raster position.
+ * Must take less than a frame (16.6ms), else frames would not be counted. */
+#define READ_CHUNK_BLOCKS   4
+
+#define VBLANKS_PER_SECOND  60
+
+static gfx_context vctx;
+
+/* Scratch block, holds the headers and the palette */
+static uint8_t s_block_buffer[TF_BLOCK_SIZE];
+
+/* Next block to read from the card */
+static uint32_t s_block;
+
+/* Number of frames displayed by the video board since the last flip, counted by `video_poll` */
+static uint8_t  s_ticks;
+static uint16_t s_last_vpos;
+
+
+static void failure(const char* msg, uint8_t err)
+{
+    ioctl(DEV_STDOUT, CMD_RESET_SCREEN, NULL);
+    printf("%s: error %d\n", msg, err);
+    exit(1);
+}
+
+
+static uint32_t parse_block(const char* str)
+{
+    uint32_t value = 0;
+    while (*str >= '0' && *str <= '9') {
+        value = value * 10 + (*str - '0');
+        str++;
+    }
+    return value;
+}
+
+
+/**
+ * @brief Count the frames output by the video board. The raster position wraps around at the end
+ *        of each frame, so it only needs to be checked at least once per frame.
+ */
+static void video_poll(void)
+{
+    /* The high byte is latched when the low byte is read */
+    const uint8_t low = zvb_ctrl_vpos_low;
+    const uint16_t vpos = (zvb_ctrl_vpos_high << 8) | low;
+    if (vpos < s_last_vpos) {
+        s_ticks++;
+    }
+    s_last_vpos = vpos;
+}
+
+
+static tf_error video_read(uint8_t* buffer)
+{
+    tf_error err = zvb_tf_read(s_block, buffer, 1);
+    s_block++;
+    video_poll();
+    return err;
+}
+
+
+/**
+ * @brief Read the pairs of tiles of a run from the card, straight to the tileset in VRAM
+ */
+static tf_error video_read_run(const frame_run_t* run)
+{
+    uint32_t phys = VID_MEM_TILESET_ADDR + (uint32_t) run->first * VIDEO_PAIR_SIZE;
+    uint8_t remaining = run->count;
+
+    while (remaining) {
+        const uint8_t count = remaining < READ_CHUNK_BLOCKS ? remaining : READ_CHUNK_BLOCKS;
+        tf_error err = zvb_tf_read_phys(s_block, phys, count);
+        if (err) {
+            return err;
+        }
+        video_poll();
+        s_block += count;
+        phys += (uint32_t) count * VIDEO_PAIR_SIZE;
+        remaining -= count;
+    }
+
+    return TF_SUCCESS;
+}
+
+
+/**
+ * @brief Load the next frame: its new tiles go to the free slots of the tileset, the encoder
+ *        makes sure they are not used by the frame currently shown. The tilemap goes to the
+ *        hidden half of layer 0.
+ */
+static tf_error video_load_frame(uint8_t back)
+{
+    const frame_header_t* header = (const frame_header_t*) s_block_buffer;
+    const uint32_t frame_block = s_block;
+
+    tf_error err = video_read(s_block_buffer);
+    if (err) {
+        return err;
+    }
+
+    if (header->run_count > VIDEO_MAX_RUNS || header->blocks == 0) {
+        return TF_READ_ERROR;
+    }
+
+    for (uint8_t i = 0; i < header->run_count; i++) {
+        err = video_read_run(&header->runs[i]);
+        if (err) {
+            return err;
+        }
+    }
+
+    const uint8_t x = back ? VIDEO_COLS : 0;
+    for (uint8_t row = 0; row < VIDEO_ROWS; row++) {
+        gfx_tilemap_load(&vctx, (void*) header->tilemap[row], VIDEO_COLS, 0, x, row);
+    }
+
+    /* The header is still in the buffer */
+    s_block = frame_block + header->blocks;
+    return TF_SUCCESS;
+}
+
+
+/**
+ * @brief Show the given half of layer 0 during the next V-blank, changing the scroll value is atomic
+ */
+static void video_flip(uint8_t back)
+{
+    const uint16_t scroll = back ? VIDEO_COLS * 16 : 0;
+    gfx_wait_vblank(&vctx);
+    zvb_ctrl_l0_scr_x_low = scroll & 0xff;
+    zvb_ctrl_l0_scr_x_high = scroll >> 8;
+    gfx_wait_end_vblank(&vctx);
+    s_ticks = 0;
+    s_last_vpos = 0;
+}
+
+
+static void video_setup(void)
+{
+    static const uint8_t transparent[VIDEO_COLS] = { 0 };
+
+    gfx_enable_screen(0);
+    gfx_error err = gfx_initialize(VIDEO_MODE, &vctx);
+    if (err) failure("Could not initialize the graphics", err);
+
+    tf_error tf_err = video_read(s_block_buffer);
+    if (tf_err) failure("Could not read the palette", tf_err);
+    gfx_palette_load(&vctx, s_block_buffer, TF_BLOCK_SIZE, 0);
+
+    /* Tile 0 is fully transparent, the video is shown on layer 0 only */
+    for (uint8_t row = 0; row < VIDEO_ROWS; row++) {
+        gfx_tilemap_load(&vctx, (void*) transparent, VIDEO_COLS, 1, 0, row);
+    }
+    zvb_ctrl_l1_scr_x_low = 0;
+    zvb_ctrl_l1_scr_x_high = 0;
+    zvb_ctrl_l1_scr_y_low = 0;
+    zvb_ctrl_l1_scr_y_high = 0;
+    zvb_ctrl_l0_scr_y_low = 0;
+    zvb_ctrl_l0_scr_y_high = 0;
+    video_flip(0);
+}
+
+
+int main(int argc, char** argv)
+{
+    /* On Zeal 8-bit OS, the argc is either 0 or 1, the strings are not split */
+    if (argc != 1) {
+        printf("usage: video.bin <first_block>\n");
+        return 1;
+    }
+    s_block = parse_block(argv[0]);
+
+    tf_error err = zvb_tf_init();
+    if (err) {
+        printf("Could not initialize the TF card: error %d\n", err);
+        return 1;
+    }
+
+    /* The palette block is full of varied data, use it to find the fastest clock for the card */
+    uint8_t clk_div;
+    err = zvb_tf_negotiate_clock(s_block + VIDEO_PALETTE_BLOCK, s_block_buffer, &clk_div);
+    if (err) {
+        printf("Could not negotiate the SPI clock: error %d\n", err);
+        return 1;
+    }
+
+    const video_header_t* header = (const video_header_t*) s_block_buffer;
+    err = video_read(s_block_buffer);
+    if (err) {
+        printf("Could not read the video header: error %d\n", err);
+        return 1;
+    }
+    if (memcmp(header->magic, VIDEO_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != VIDEO_VERSION || header->mode != VIDEO_MODE ||
+        header->cols != VIDEO_COLS || header->rows != VIDEO_ROWS ||
+        header->fps == 0 || (VBLANKS_PER_SECOND % header->fps) != 0)
+    {
+        printf("Invalid or unsupported video at block %lu\n", s_block - 1);
+        return 1;
+    }
+    const uint16_t frames = header->frames;
+    const uint8_t period = VBLANKS_PER_SECOND / header->fps;
+
+    video_setup();
+
+    uint16_t late = 0;
+    uint8_t back = 1;
+    for (uint16_t i = 0; i < frames; i++) {
+        err = video_load_frame(back);
+        if (err) failure("Could not read the frame", err);
+
+        if (i == 0) {
+            gfx_enable_screen(1);
+        } else if (s_ticks >= period) {
+            /* The frame took longer than its period to load */
+            late++;
+        }
+        /* Keep the current frame on screen for its whole period */
+        while (s_ticks < period - 1) {
+            video_poll();
+        }
+        video_flip(back);
+        back ^= 1;
+    }
+
+    ioctl(DEV_STDOUT, CMD_RESET_SCREEN, NULL);
+    printf("%u frames played, %u late\n", frames, late);
+    return 0;
+}
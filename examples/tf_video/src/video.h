@@ -0,0 +1,71 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zvb_hardware.h>
+
+/**
+ * @brief Format of the video stream written on the TF card by `tools/video2zeal/video2zeal.py`,
+ *        must be kept in sync with it. Every structure starts on a block boundary so that the
+ *        tiles can be read from the card straight to VRAM.
+ *
+ * Block 0: video header (`video_header_t`)
+ * Block 1: palette, 256 RGB565 colors
+ * Block 2 and above: frames, one after the other. Each frame is made of:
+ *   - A frame header block (`frame_header_t`), followed by the tilemap and the runs
+ *   - The new tiles of the frame, two 8-bit tiles per block, in the order of the runs
+ */
+
+#define VIDEO_MAGIC         "ZTV"
+#define VIDEO_VERSION       1
+#define VIDEO_PALETTE_BLOCK 1
+#define VIDEO_FIRST_FRAME   2
+
+/* Only the 320x240 8-bit mode is supported: 20x15 tiles, 256 tiles of 256 bytes */
+#define VIDEO_MODE          ZVB_CTRL_VID_MODE_GFX_320_8BIT
+#define VIDEO_COLS          20
+#define VIDEO_ROWS          15
+#define VIDEO_TILE_SIZE     256
+
+/* A pair of tiles fills a block, pair `n` contains the tiles `2n` and `2n+1`.
+ * Pair 0 is never written by the stream, tile 0 stays transparent for layer 1. */
+#define VIDEO_PAIR_SIZE     (2 * VIDEO_TILE_SIZE)
+
+
+typedef struct {
+    char     magic[3];
+    uint8_t  version;
+    /* Frames per second, must be a divisor of 60 */
+    uint8_t  fps;
+    uint8_t  mode;
+    uint8_t  cols;
+    uint8_t  rows;
+    uint16_t frames;
+    /* Total size of the stream, including this header */
+    uint32_t blocks;
+} video_header_t;
+
+
+typedef struct {
+    /* First pair to write and number of consecutive pairs */
+    uint8_t first;
+    uint8_t count;
+} frame_run_t;
+
+
+typedef struct {
+    /* Size of the frame in blocks, including this header block */
+    uint16_t blocks;
+    uint8_t  run_count;
+    uint8_t  reserved;
+    uint8_t  tilemap[VIDEO_ROWS][VIDEO_COLS];
+    /* Followed by `run_count` runs */
+    frame_run_t runs[];
+} frame_header_t;
+
+#define VIDEO_MAX_RUNS  ((512 - sizeof(frame_header_t)) / sizeof(frame_run_t))
@@ -35,3 +35,18 @@ void zvb_crc_reset(void);
  * @return CRC32 result
  */
 uint32_t zvb_crc_update(uint8_t *buffer, uint16_t size)  __sdcccall(1);
+
+
+/**
+ * @brief Update the CRC calculation with a physical memory region, which can be bigger than 64KB
+ *        and span several 16KB pages, such as VRAM or ROM banks.
+ *
+ * @note The region is mapped in the virtual page 0, 4KB at a time, with the interrupts disabled,
+ *       their state is restored afterwards. The caller's code and data must not be located in page 0.
+ *
+ * @param phys Physical address of the first byte to feed to the CRC calculation
+ * @param length Number of bytes to feed
+ *
+ * @return CRC32 result
+ */
+uint32_t zvb_crc_update_phys(uint32_t phys, uint32_t length);
@@ -0,0 +1,41 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zos_vfs.h>
+#include "zvb_crc.h"
+
+
+/**
+ * @brief Statistics filled by `zvb_crc_file`. The times are measured with the system timer, they
+ *        are 0 if the target has none.
+ */
+typedef struct {
+    uint32_t bytes;     // Number of bytes read from the file
+    uint32_t read_ms;   // Time spent reading the file, in milliseconds
+    uint32_t crc_ms;    // Time spent feeding the CRC peripheral, in milliseconds
+    uint32_t rate;      // Overall throughput, in bytes per second
+} zvb_crc_stats_t;
+
+
+/**
+ * @brief Calculate the CRC32 of a file, from its current position to its end.
+ *
+ * @note The buffer is filled completely before being fed to the peripheral, so the larger the
+ *       buffer, the fewer the system calls. 8KB or 16KB get close to the raw read speed.
+ *
+ * @param fd Opened file to read
+ * @param buffer Buffer to read the file into (must NOT be NULL)
+ * @param size Size of the buffer, in bytes
+ * @param crc Filled with the CRC32 of the file
+ * @param stats Filled with the size of the file and the throughput, can be NULL
+ *
+ * @return ERR_SUCCESS on success, ERR_INVALID_PARAMETER if a parameter is invalid,
+ *         error returned by `read` else
+ */
+zos_err_t zvb_crc_file(zos_dev_t fd, uint8_t* buffer, uint16_t size, uint32_t* crc, zvb_crc_stats_t* stats);
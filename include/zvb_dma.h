@@ -11,6 +11,27 @@
 
 #define DMA_DESC_LAST 1
 
+#define DMA_SUCCESS     0
+#define DMA_FAILURE     1
+#define DMA_INVALID_ARG 2
+#define DMA_NO_SPACE    3
+
+/**
+ * @brief Size of a virtual page, as seen by the CPU through the MMU
+ */
+#define DMA_VIRT_PAGE_SIZE  (16*1024)
+
+/**
+ * @brief Number of chains that can be waiting in the transfer queue, must be a power of 2
+ */
+#define DMA_QUEUE_SIZE      8
+
+/**
+ * @brief Transfer size, in bytes, from which `zvb_dma_memcpy` uses the DMA instead of the CPU,
+ *        until `zvb_dma_benchmark` measures the actual crossover
+ */
+#define DMA_DEFAULT_CROSSOVER   64
+
 typedef union {
     struct {
         uint8_t rd_cycle : 4;
@@ -46,6 +67,18 @@ typedef struct {
     dma_flags_t flags;
 } zvb_dma_descriptor_config_t;
 
+/**
+ * @brief Chain of descriptors built in a caller-provided arena. The DMA controller
+ * fetches the descriptors one after the other, until it finds one with the `last`
+ * flag set, so the arena must be contiguous in physical memory: it must not cross
+ * a 16KB virtual page boundary.
+ */
+typedef struct {
+    zvb_dma_descriptor_t* descs;  // Arena holding the descriptors
+    uint8_t capacity;             // Number of descriptors the arena can hold
+    uint8_t count;                // Number of descriptors currently in the chain
+} zvb_dma_chain_t;
+
 
 uint32_t zvb_dma_virt_to_phys(void* ptr) __naked;
 uint8_t zvb_dma_prepare_descriptor(zvb_dma_descriptor_t* desc, zvb_dma_descriptor_config_t* config);
@@ -54,3 +87,261 @@ uint8_t zvb_dma_set_read_virt(zvb_dma_descriptor_t* desc, void* ptr);
 uint8_t zvb_dma_set_write(zvb_dma_descriptor_t* desc, uint32_t addr);
 uint8_t zvb_dma_set_write_virt(zvb_dma_descriptor_t* desc, void* ptr);
 uint8_t zvb_dma_start_transfer(zvb_dma_descriptor_t *desc);
+
+
+/**
+ * @brief `zvb_dma_set_read_virt` and `zvb_dma_set_write_virt` only translate the given pointer with
+ *        the MMU page it belongs to, so they are only valid for buffers that don't cross a 16KB virtual page.
+ *        The following variants take the length of the buffer and fill as many consecutive descriptors
+ *        as virtual pages the buffer spans, reading each page register. Each descriptor gets the
+ *        physical address and the length of its part, the other address must be set by the caller.
+ *        The parts are contiguous in the buffer, split at the 16KB page boundaries.
+ *
+ * @param desc Array of descriptors to fill
+ * @param count Number of descriptors in the array
+ * @param ptr Virtual address of the buffer, it must be mapped when calling this function
+ * @param length Size of the buffer in bytes
+ *
+ * @return Number of descriptors filled, 0 if the array is too small or if a parameter is invalid
+ */
+uint8_t zvb_dma_set_read_virt_len(zvb_dma_descriptor_t* desc, uint8_t count, void* ptr, uint16_t length);
+uint8_t zvb_dma_set_write_virt_len(zvb_dma_descriptor_t* desc, uint8_t count, void* ptr, uint16_t length);
+
+
+/**
+ * @brief Initialize an empty chain of descriptors.
+ *
+ * @param chain Chain to initialize
+ * @param arena Array of descriptors the chain will be built in, it must not cross a 16KB page
+ * @param capacity Number of descriptors in the arena
+ *
+ * @return DMA_SUCCESS on success, DMA_INVALID_ARG if the arena is invalid or crosses a page boundary
+ */
+uint8_t zvb_dma_chain_init(zvb_dma_chain_t* chain, zvb_dma_descriptor_t* arena, uint8_t capacity);
+
+
+/**
+ * @brief Empty the chain so that it can be reused. The arena is kept.
+ */
+void zvb_dma_chain_reset(zvb_dma_chain_t* chain);
+
+
+/**
+ * @brief Append a transfer between two physical addresses to the chain.
+ *        The new descriptor becomes the last one of the chain.
+ *
+ * @param chain Chain to append the transfer to
+ * @param rd_addr Physical address to read from
+ * @param wr_addr Physical address to write to
+ * @param length Number of bytes to transfer
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the arena is full
+ */
+uint8_t zvb_dma_chain_add(zvb_dma_chain_t* chain, uint32_t rd_addr, uint32_t wr_addr, uint16_t length);
+
+
+/**
+ * @brief Append a transfer from a virtual buffer to a physical address to the chain.
+ *        The buffer is split in several descriptors if it crosses 16KB virtual pages,
+ *        each part is translated with the MMU page it currently belongs to.
+ *
+ * @param chain Chain to append the transfer to
+ * @param src Virtual address of the source buffer, it must be mapped when calling this function
+ * @param wr_addr Physical address to write to
+ * @param length Number of bytes to transfer
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the arena is too small,
+ *         in that case, the chain is left unmodified
+ */
+uint8_t zvb_dma_chain_add_virt(zvb_dma_chain_t* chain, void* src, uint32_t wr_addr, uint16_t length);
+
+
+/**
+ * @brief Append a transfer from a physical address to a virtual buffer to the chain.
+ *        The destination buffer is split at each 16KB virtual page boundary it crosses.
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the arena is too small,
+ *         in that case, the chain is left unmodified
+ */
+uint8_t zvb_dma_chain_add_to_virt(zvb_dma_chain_t* chain, uint32_t rd_addr, void* dst, uint16_t length);
+
+
+/**
+ * @brief Append a transfer between two virtual buffers to the chain. The transfer is split
+ *        whenever the source or the destination crosses a 16KB virtual page boundary, so both
+ *        buffers can be of any size and be backed by non-contiguous physical pages.
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the arena is too small,
+ *         in that case, the chain is left unmodified
+ */
+uint8_t zvb_dma_chain_copy_virt(zvb_dma_chain_t* chain, void* dst, void* src, uint16_t length);
+
+
+/**
+ * @brief Start the transfer of the whole chain with a single DMA request.
+ *
+ * @return DMA_SUCCESS on success, DMA_INVALID_ARG if the chain is empty
+ */
+uint8_t zvb_dma_chain_start(zvb_dma_chain_t* chain);
+
+
+/**
+ * @brief Check whether the DMA controller is currently processing descriptors.
+ *
+ * @note After calling this function, the DMA peripheral will be mapped in the peripheral bank.
+ *
+ * @return 1 if a transfer is in progress, 0 else
+ */
+uint8_t zvb_dma_busy(void);
+
+
+/**
+ * @brief Wait for the current transfer, if any, to finish.
+ */
+void zvb_dma_wait(void);
+
+
+/**
+ * @brief Add a chain to the transfer queue. If the controller is idle and the queue
+ *        is empty, the chain is started right away. Else, it will be started by
+ *        `zvb_dma_service` once the previous transfers are done.
+ *
+ * @note The chain and its arena must stay valid until the transfer is finished.
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the queue is full
+ */
+uint8_t zvb_dma_queue_push(zvb_dma_chain_t* chain);
+
+
+/**
+ * @brief Start the next chain of the queue if the controller is idle.
+ *        Can be called when polling or from the v-blank interrupt handler,
+ *        the previously mapped peripheral is restored before returning. The interrupts are
+ *        disabled while the queue is updated, their state is restored afterwards.
+ *        Does nothing while `zvb_dma_calibrate`, `zvb_dma_benchmark` or `zvb_dma_memcpy`
+ *        use the controller, these functions flush the queue before starting their own transfers.
+ */
+void zvb_dma_service(void);
+
+
+/**
+ * @brief Get the number of chains that have not been started yet.
+ */
+uint8_t zvb_dma_queue_pending(void);
+
+
+/**
+ * @brief Wait until all the chains from the queue have been transferred.
+ */
+void zvb_dma_queue_flush(void);
+
+
+/**
+ * @brief Append a fill (memset) transfer to the chain, for example to clear a tilemap layer
+ *        or a tileset page without CPU involvement. This requires two descriptors.
+ *
+ * @note The first descriptor stores the value to fill with in its reserved bytes and copies
+ *       them to the destination. The second descriptor copies the destination onto itself,
+ *       shifted by the size of the seed, so its read address always trails the write address.
+ *       This assumes the controller transfers one byte at a time, in increasing address order,
+ *       and writes each byte before reading the next one, without reading ahead. This is how the
+ *       current controller behaves, but it is not a documented guarantee of the hardware: on a
+ *       controller that buffers its reads, the overlapping copy would replicate stale bytes. In
+ *       that case, fill a buffer with the CPU and transfer it with `zvb_dma_chain_add` instead.
+ *
+ * @param chain Chain to append the transfer to
+ * @param wr_addr Physical address to fill
+ * @param value Byte to fill the destination with
+ * @param length Number of bytes to fill
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the arena is too small
+ */
+uint8_t zvb_dma_chain_fill(zvb_dma_chain_t* chain, uint32_t wr_addr, uint8_t value, uint16_t length);
+
+
+/**
+ * @brief Append a repeat-pattern transfer to the chain. The destination is stamped with the
+ *        pattern until `length` bytes have been written, the last repetition may be truncated.
+ *        Same as `zvb_dma_chain_fill`, the pattern is written once and then replicated
+ *        by a transfer whose read address trails the write address by `pattern_len` bytes.
+ *
+ * @note The pattern buffer must stay valid until the transfer is finished.
+ * @note The overlapping copy relies on the same byte by byte, increasing order transfers as
+ *       `zvb_dma_chain_fill`.
+ *
+ * @param chain Chain to append the transfer to
+ * @param wr_addr Physical address of the destination
+ * @param pattern Virtual address of the pattern to repeat
+ * @param pattern_len Size of the pattern in bytes
+ * @param length Total number of bytes to write
+ *
+ * @return DMA_SUCCESS on success, DMA_NO_SPACE if the arena is too small
+ */
+uint8_t zvb_dma_chain_pattern(zvb_dma_chain_t* chain, uint32_t wr_addr, void* pattern, uint16_t pattern_len, uint16_t length);
+
+
+/**
+ * @brief Set the number of clock cycles the controller spends on each read and write.
+ *        The value is kept so that it can be retrieved with `zvb_dma_get_clock`.
+ */
+void zvb_dma_set_clock(zvb_dma_clk_t clk);
+
+
+/**
+ * @brief Get the current DMA clock setting.
+ */
+zvb_dma_clk_t zvb_dma_get_clock(void);
+
+
+/**
+ * @brief Look for the fastest read and write timings that transfer data correctly between the
+ *        given physical regions, for example RAM to VRAM, VRAM to VRAM or ROM to VRAM.
+ *        Each setting is tested by transferring the data and comparing the CRC32 of both regions,
+ *        calculated by the CRC library, which must be linked too. The fastest passing setting
+ *        is stored and applied.
+ *
+ * @note The destination is overwritten.
+ *
+ * @param rd_addr Physical address of the source region
+ * @param wr_addr Physical address of the destination region
+ * @param length Size of both regions, in bytes
+ * @param result Fastest setting found, can be NULL
+ *
+ * @return DMA_SUCCESS on success, DMA_FAILURE if even the slowest setting fails
+ */
+uint8_t zvb_dma_calibrate(uint32_t rd_addr, uint32_t wr_addr, uint16_t length, zvb_dma_clk_t* result);
+
+
+/**
+ * @brief Measure the time needed to copy buffers of increasing sizes (powers of 2) from RAM to
+ *        the given physical address, with the DMA and with an `ldir` copy. The time is measured
+ *        with the raster position counters, which wrap around every frame, so the measurement stops
+ *        once a copy takes more than half a frame: the next size could take longer than a frame.
+ *        The smallest size for which the DMA is faster is stored and used by `zvb_dma_memcpy`.
+ *
+ * @note The destination is overwritten.
+ *
+ * @param src Virtual address of the source buffer
+ * @param wr_addr Physical address of the destination
+ * @param max_length Size of the source buffer, biggest size to test
+ *
+ * @return Smallest size, in bytes, for which the DMA is faster than the CPU, 0xFFFF if the
+ *         CPU was always faster
+ */
+uint16_t zvb_dma_benchmark(void* src, uint32_t wr_addr, uint16_t max_length);
+
+
+/**
+ * @brief Copy a buffer to the given physical address, choosing the CPU or the DMA depending on
+ *        the size of the transfer. The function returns once the copy is finished.
+ *
+ * @note The CPU copy maps the destination in the virtual page 0 with the interrupts disabled,
+ *       their state is restored afterwards.
+ *
+ * @param wr_addr Physical address to copy the buffer to
+ * @param src Virtual address of the buffer to copy
+ * @param length Number of bytes to copy
+ *
+ * @return DMA_SUCCESS on success, error code else
+ */
+uint8_t zvb_dma_memcpy(uint32_t wr_addr, void* src, uint16_t length);
@@ -14,6 +14,9 @@ typedef uint8_t gfx_error;
 #define GFX_SUCCESS     0
 #define GFX_FAILURE     1
 #define GFX_INVALID_ARG 2
+/* Only returned by the load functions when the library is built with GFX_VERIFY defined:
+ * the content read back from VRAM doesn't match the content written */
+#define GFX_VERIFY_FAILED   3
 
 
 #define TILESET_COMP_NONE   0
@@ -371,7 +371,8 @@ IOB(ZVB_PERI_BASE + 0xe) zvb_peri_sound_master_vol;
 
 
 IOB(ZVB_PERI_BASE + 0x0) zvb_peri_dma_ctrl;     // (R/W) Control register, check the bits defined below
-#define ZVB_PERI_DMA_CTRL_START     0x80
+#define ZVB_PERI_DMA_CTRL_START     0x80    // (WO) Start processing the descriptors
+#define ZVB_PERI_DMA_CTRL_BUSY      0x80    // (RO) Set while the descriptors are being processed
 
 IOB(ZVB_PERI_BASE + 0x1) zvb_peri_dma_addr0;  // (WO)
 IOB(ZVB_PERI_BASE + 0x2) zvb_peri_dma_addr1;  // (WO)
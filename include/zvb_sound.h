@@ -12,6 +12,11 @@
 #define SOUND_FREQ_TO_DIV(FREQ)     (65536*(FREQ) / 44091)
 #define SOUND_SAMPLE_TABLE_SIZE     256
 
+/* Registers to write with `zvb_sound_write_locked` */
+#define SOUND_WRITE_FREQ    (1 << 0)
+#define SOUND_WRITE_WAVE    (1 << 1)
+#define SOUND_WRITE_VOL     (1 << 2)
+
 typedef enum {
     VOICE0 = 1 << 0,
     VOICE1 = 1 << 1,
@@ -70,6 +75,16 @@ typedef enum {
  } sound_samples_conf_t;
 
 
+/**
+ * @brief Status of the asynchronous sample playback
+ */
+typedef enum {
+    SOUND_ASYNC_STOPPED,    // Nothing is being played, the sample table voice is on hold
+    SOUND_ASYNC_PLAYING,    // Samples are waiting in the ring buffer
+    SOUND_ASYNC_DRAINING,   // The ring buffer is empty, the FIFO may still contain samples to play
+} sound_async_status_t;
+
+
 /**
  * @brief Initialize the sound peripheral.
  *
@@ -89,6 +104,9 @@ void zvb_sound_reset(void);
 /**
  * @brief Set one or multiple voices outputs.
  *
+ * @note The registers are shadowed, only the values that differ from the current ones are written.
+ *       Any change staged with the `zvb_sound_stage_*` functions is also committed.
+ *
  * @param voices Voices to set, the VOICE[0-3] values can be ORed.
  *        SAMPTAB must NOT be specified.
  */
@@ -110,6 +128,82 @@ void zvb_sound_set_voices_vol(sound_voice_t voices, sound_volume_t vol);
 void zvb_sound_set_hold(sound_voice_t voices, uint8_t hold);
 
 
+/**
+ * @brief Get the voices on hold, as last staged or set, locked voices are not taken into account
+ */
+sound_voice_t zvb_sound_get_hold(void);
+
+
+/**
+ * @brief Stage a new divider for one or multiple voices, it will be written on the next
+ *        call to `zvb_sound_commit`. Staging doesn't perform any I/O.
+ *
+ * @param voices Voices to set, the VOICE[0-3] values can be ORed.
+ */
+void zvb_sound_stage_freq(sound_voice_t voices, uint16_t divider);
+
+
+/**
+ * @brief Stage a new waveform, optionally ORed with a duty cycle, for one or multiple voices.
+ *
+ * @param voices Voices to set, the VOICE[0-3] values can be ORed.
+ */
+void zvb_sound_stage_wave(sound_voice_t voices, uint8_t waveform);
+
+
+/**
+ * @brief Stage a new volume for one or multiple voices.
+ *
+ * @param voices Voices to set, the VOICE[0-3] values can be ORed.
+ */
+void zvb_sound_stage_vol(sound_voice_t voices, sound_volume_t vol);
+
+
+/**
+ * @brief Stage a hold (mute) or unhold (start) of the given voice(s), the hold register is
+ *        written after all the other staged registers.
+ */
+void zvb_sound_stage_hold(sound_voice_t voices, uint8_t hold);
+
+
+/**
+ * @brief Write all the staged values that differ from the registers content. Voices sharing the
+ *        same new value are written at once. Meant to be called once per frame by sequencers.
+ */
+void zvb_sound_commit(void);
+
+
+/**
+ * @brief Lock voices for exclusive use, for example by sound effects. The values staged for the
+ *        locked voices, by a sequencer for example, are not written to the registers but kept
+ *        until the voices are unlocked. Locked voices start on hold.
+ *
+ * @param voices Voices to lock, the VOICE[0-3] values can be ORed.
+ */
+void zvb_sound_lock(sound_voice_t voices);
+
+
+/**
+ * @brief Unlock voices, their staged values and hold state will be restored on the next commit.
+ */
+void zvb_sound_unlock(sound_voice_t voices);
+
+
+/**
+ * @brief Write the registers of locked voices right away, the staged values are left untouched.
+ *
+ * @param voices Voices to write, the ones that are not locked are ignored
+ * @param flags Registers to write, SOUND_WRITE_* values can be ORed
+ */
+void zvb_sound_write_locked(sound_voice_t voices, uint8_t flags, uint16_t divider, uint8_t waveform, sound_volume_t vol);
+
+
+/**
+ * @brief Hold (mute) or unhold (start) locked voices right away.
+ */
+void zvb_sound_hold_locked(sound_voice_t voices, uint8_t hold);
+
+
 /**
  * @brief Assign voices to the channels.
  *
@@ -141,3 +235,102 @@ void zvb_sound_set_volumes(sound_volume_t left, sound_volume_t right);
  * @param length Length of the table
  */
 void zvb_sound_play_samples(sound_samples_conf_t* config, void* samples, uint16_t length);
+
+
+/**
+ * @brief Start an asynchronous playback on the sample table voice, fed from a ring buffer.
+ *        The ring buffer is empty after this call, fill it with `zvb_sound_async_write` and call
+ *        `zvb_sound_service` regularly (every frame or from the v-blank handler) to top up the FIFO.
+ *
+ * @param config Sign, bit-width and sample rate divider of the samples
+ * @param ring Buffer used as the ring, it must stay valid until the playback is stopped
+ * @param size Size of the ring buffer in bytes
+ */
+void zvb_sound_async_start(sound_samples_conf_t* config, void* ring, uint16_t size);
+
+
+/**
+ * @brief Copy samples to the ring buffer of the current asynchronous playback.
+ *
+ * @return Number of bytes actually copied, it can be less than `length` if the ring buffer is full
+ */
+uint16_t zvb_sound_async_write(const void* samples, uint16_t length);
+
+
+/**
+ * @brief Get the number of bytes that can be written to the ring buffer.
+ */
+uint16_t zvb_sound_async_free(void);
+
+
+/**
+ * @brief Get a pointer to the free space of the ring buffer, to fill it in place, for example
+ *        directly from a file. Only the contiguous part, before the end of the ring, is returned.
+ *        Once filled, the bytes must be committed with `zvb_sound_async_commit`.
+ *
+ * @param length Filled with the number of bytes that can be written at the returned address
+ *
+ * @return Address to write the samples to, NULL if the playback is stopped or ended
+ */
+uint8_t* zvb_sound_async_reserve(uint16_t* length);
+
+
+/**
+ * @brief Commit bytes written in place in the ring buffer, they will be played after the
+ *        ones already in the ring.
+ *
+ * @param length Number of bytes written, must not be bigger than the value returned by
+ *               `zvb_sound_async_reserve`
+ */
+void zvb_sound_async_commit(uint16_t length);
+
+
+/**
+ * @brief Notify that no more samples will be written to the ring buffer. The playback stops
+ *        by itself once all the samples have been played.
+ */
+void zvb_sound_async_end(void);
+
+
+/**
+ * @brief Play samples on the sample table voice without blocking. The buffer is used directly as a
+ *        full ring buffer, no copy is performed, it must stay valid until the playback is over.
+ *        `zvb_sound_service` must be called regularly until the status is `SOUND_ASYNC_STOPPED`.
+ *
+ * @param config Sign, bit-width and sample rate divider of the samples
+ * @param samples Table containing the samples to play
+ * @param length Length of the table
+ */
+void zvb_sound_play_samples_async(sound_samples_conf_t* config, void* samples, uint16_t length);
+
+
+/**
+ * @brief Top up the sample table FIFO from the ring buffer until it is full or the ring buffer
+ *        is empty. This function can be called from the v-blank handler, the previously mapped
+ *        peripheral and the selected voices are restored before returning.
+ */
+void zvb_sound_service(void);
+
+
+/**
+ * @brief Get the status of the asynchronous playback.
+ */
+sound_async_status_t zvb_sound_async_status(void);
+
+
+/**
+ * @brief Stop the asynchronous playback right away, the samples left in the ring buffer are dropped.
+ */
+void zvb_sound_async_stop(void);
+
+
+/**
+ * @brief Write samples to the sample table FIFO, as many as it can take. When the FIFO is empty,
+ *        a whole block of 256 bytes is written at once with `otir`, the remaining bytes are
+ *        written one by one until the FIFO is full.
+ *
+ * @note The sound peripheral must be mapped and the sample table voice must be selected.
+ *
+ * @return Number of bytes written to the FIFO
+ */
+uint16_t zvb_sound_fifo_write(const void* samples, uint16_t length);
@@ -0,0 +1,76 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zos_errors.h>
+#include "zvb_sound.h"
+
+/**
+ * @brief IMA-ADPCM clips, as generated by `tools/wav2adpcm`, are decoded on the fly into the
+ *        asynchronous ring buffer of the sample table voice. Each byte contains two 4-bit samples,
+ *        low nibble first, they are decoded into 8-bit unsigned samples.
+ *
+ * The clip starts with a header, all values are little-endian:
+ *
+ *   Offset  Size   Description
+ *   0       3      Magic "ZAD"
+ *   3       1      Version, must be ADPCM_VERSION
+ *   4       1      Sample rate divider
+ *   5       1      Initial step index (0-88)
+ *   6       2      Initial predictor, as an unsigned 16-bit value (0x8000 being the silence)
+ *   8       2      Number of bytes of ADPCM data following the header
+ *
+ * @note Decoding a sample takes roughly 380 T-states, which is about 40% of the CPU time at
+ *       divider 3 (~11kHz) and 85% at divider 1 (~22kHz) on a 10MHz Z80. The decoder uses a
+ *       1424-byte table, computed on the first call to `zvb_sound_adpcm_start`.
+ */
+
+#define ADPCM_VERSION       1
+#define ADPCM_HEADER_SIZE   10
+
+typedef struct {
+    char     magic[3];
+    uint8_t  version;
+    uint8_t  divider;
+    uint8_t  index;
+    uint16_t predictor;
+    uint16_t length;
+} zvb_adpcm_header_t;
+
+
+/**
+ * @brief Start playing an ADPCM clip asynchronously on the sample table voice.
+ *        `zvb_sound_adpcm_service` must then be called regularly, until the asynchronous status
+ *        is `SOUND_ASYNC_STOPPED`.
+ *
+ * @param clip Clip to play, header included, it must stay valid while it is being played
+ * @param ring Ring buffer to decode the samples to, its size must be even
+ * @param size Size of the ring buffer in bytes
+ *
+ * @return ERR_SUCCESS on success, ERR_INVALID_PARAMETER if the clip or the ring is not valid
+ */
+zos_err_t zvb_sound_adpcm_start(const void* clip, void* ring, uint16_t size);
+
+
+/**
+ * @brief Decode the next samples of the current clip into the ring buffer, until it is full,
+ *        and top up the FIFO with `zvb_sound_service` between each chunk.
+ */
+void zvb_sound_adpcm_service(void);
+
+
+/**
+ * @brief Play an ADPCM clip on the sample table voice and return when it is over.
+ *
+ * @param clip Clip to play, header included
+ * @param ring Ring buffer to decode the samples to, its size must be even
+ * @param size Size of the ring buffer in bytes
+ *
+ * @return ERR_SUCCESS on success, ERR_INVALID_PARAMETER if the clip or the ring is not valid
+ */
+zos_err_t zvb_sound_play_adpcm(const void* clip, void* ring, uint16_t size);
@@ -0,0 +1,124 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_sound.h"
+
+/**
+ * @brief Per-voice effect processor for the voices VOICE0 to VOICE3. A note played with an
+ *        instrument follows its tables, one entry per call to `zvb_sound_fx_tick`:
+ *        - volume envelope, quantized to the 5 hardware steps
+ *        - pitch offsets added to the divider, for vibrato or arpeggios
+ *        - waveform and duty cycle, for duty sweeps
+ *        - pitch slide, added to the divider every tick
+ */
+
+#define FX_VOICES       4
+#define FX_NO_LOOP      0xff
+#define FX_NO_SUSTAIN   0xff
+
+/* Volume levels used in the envelopes */
+#define FX_VOL_0        0
+#define FX_VOL_25       1
+#define FX_VOL_50       2
+#define FX_VOL_75       3
+#define FX_VOL_100      4
+
+
+/**
+ * @brief Table of values, one value per tick
+ */
+typedef struct {
+    const void* data;   // Values, the type depends on the table, NULL or length 0 for none
+    uint8_t length;     // Number of values
+    uint8_t loop;       // Index to continue from after the last value, FX_NO_LOOP to keep the last value
+    uint8_t sustain;    // Volume only: index kept until the note is released, FX_NO_SUSTAIN for none
+} zvb_fx_table_t;
+
+
+/**
+ * @brief Instrument, all the tables are optional
+ */
+typedef struct {
+    zvb_fx_table_t volume;  // FX_VOL_* levels (uint8_t), the note ends when the last value is FX_VOL_0
+    zvb_fx_table_t pitch;   // Signed offsets added to the divider (int8_t)
+    zvb_fx_table_t wave;    // Waveforms ORed with a duty cycle (uint8_t)
+    uint8_t waveform;       // Waveform used when there is no wave table
+    int16_t slide;          // Signed value added to the divider on each tick
+    uint16_t divider;       // Fixed divider, used by drums, 0 to use the note divider
+} zvb_fx_instrument_t;
+
+
+/**
+ * @brief Drum presets based on noise and pitch slides, the note divider is ignored.
+ */
+extern const zvb_fx_instrument_t zvb_fx_kick;
+extern const zvb_fx_instrument_t zvb_fx_snare;
+extern const zvb_fx_instrument_t zvb_fx_hihat;
+
+
+/**
+ * @brief Build an ADSR volume envelope table.
+ *
+ * @param table Table to initialize, it will point to `buffer`
+ * @param buffer Buffer to store the levels in, it must stay valid while the table is in use
+ * @param size Size of the buffer, at least attack + decay + release + 1 bytes
+ * @param attack Number of ticks to go from FX_VOL_0 to FX_VOL_100
+ * @param decay Number of ticks to go from FX_VOL_100 to the sustain level
+ * @param sustain Level kept until the note is released, FX_VOL_0 to FX_VOL_100
+ * @param release Number of ticks to go from the sustain level to FX_VOL_0
+ *
+ * @return Length of the table, 0 if the buffer is too small or the sustain level invalid
+ */
+uint8_t zvb_sound_fx_adsr(zvb_fx_table_t* table, uint8_t* buffer, uint8_t size,
+                          uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release);
+
+
+/**
+ * @brief Start a note with the given instrument, the registers are updated on the next tick.
+ *
+ * @param voice Index of the voice, 0 to 3
+ * @param instrument Instrument to play the note with, it must stay valid while the note is playing
+ * @param divider Divider of the note, as returned by SOUND_FREQ_TO_DIV
+ */
+void zvb_sound_fx_note_on(uint8_t voice, const zvb_fx_instrument_t* instrument, uint16_t divider);
+
+
+/**
+ * @brief Release the note played on the given voice, its volume envelope continues after the
+ *        sustain point. Without any sustain point, the note is stopped right away.
+ */
+void zvb_sound_fx_note_off(uint8_t voice);
+
+
+/**
+ * @brief Stop the note played on the given voice right away and hold the voice.
+ */
+void zvb_sound_fx_stop(uint8_t voice);
+
+
+/**
+ * @brief Glide (portamento) the note of the given voice to a new divider.
+ *
+ * @param speed Value added to, or subtracted from, the divider on each tick until it is reached
+ */
+void zvb_sound_fx_glide(uint8_t voice, uint16_t divider, uint16_t speed);
+
+
+/**
+ * @brief Check whether a note is playing on the given voice.
+ */
+uint8_t zvb_sound_fx_playing(uint8_t voice);
+
+
+/**
+ * @brief Advance all the notes by one tick and commit the registers. It must be called once per
+ *        frame, after `zvb_sound_seq_tick` if a song is also being played. Each voice update is a
+ *        few table reads, the registers are only written when their value changes.
+ */
+void zvb_sound_fx_tick(void);
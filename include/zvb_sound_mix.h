@@ -0,0 +1,91 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_sound.h"
+
+/**
+ * @brief Software mixer for the sample table voice. Up to MIX_CHANNELS sound effects, made of
+ *        8-bit unsigned samples, are summed with saturation and fed to the asynchronous ring buffer.
+ *
+ * The mixing cost grows with the number of active channels, each channel costs about
+ * 80 T-states per sample, plus 8 T-states per volume shift, on top of a fixed 60 T-states per
+ * sample. Run `examples/audio_mixer` to measure it at the common dividers.
+ */
+
+#define MIX_CHANNELS        4
+#define MIX_NO_CHANNEL      0xff
+
+/* Number of samples mixed between two FIFO top ups */
+#define MIX_CHUNK_SIZE      128
+
+
+/**
+ * @brief Sound effect to play on a mixer channel
+ */
+typedef struct {
+    const uint8_t* samples; // 8-bit unsigned samples, played at the mixer sample rate
+    uint16_t length;        // Number of samples
+    uint8_t shift;          // Volume, the samples are divided by 2^shift (0-7)
+    uint8_t priority;       // When all the channels are busy, the lowest priority one is stolen
+} zvb_mix_sfx_t;
+
+
+/**
+ * @brief Start the mixer on the sample table voice.
+ *
+ * @param channels Number of channels to mix, between 1 and MIX_CHANNELS
+ * @param divider Sample rate divider, common to all the sound effects
+ * @param ring Ring buffer to mix the samples in, the smaller it is, the lower the latency
+ * @param size Size of the ring buffer, MIX_CHUNK_SIZE or 2 * MIX_CHUNK_SIZE is recommended
+ */
+void zvb_sound_mix_start(uint8_t channels, uint8_t divider, void* ring, uint16_t size);
+
+
+/**
+ * @brief Play a sound effect on a free channel. When all the channels are busy, the channel with the
+ *        lowest priority is stolen, if it is not higher than the new sound effect's. Among channels
+ *        of equal priority, the one closest to its end is stolen.
+ *
+ * @param sfx Sound effect to play, the samples must stay valid while they are played
+ *
+ * @return Index of the channel the sound effect is played on, MIX_NO_CHANNEL if none could be found
+ */
+uint8_t zvb_sound_mix_play(const zvb_mix_sfx_t* sfx);
+
+
+/**
+ * @brief Stop the sound effect played on the given channel.
+ */
+void zvb_sound_mix_stop(uint8_t channel);
+
+
+/**
+ * @brief Get the channels currently playing a sound effect.
+ *
+ * @return Bitmap of the active channels, bit 0 being channel 0
+ */
+uint8_t zvb_sound_mix_active(void);
+
+
+/**
+ * @brief Mix the active channels into the given buffer, as 8-bit unsigned samples.
+ *        The channels are advanced by `count` samples.
+ *
+ * @param dst Buffer to store the mixed samples in
+ * @param count Number of samples to mix
+ */
+void zvb_sound_mix_render(uint8_t* dst, uint16_t count);
+
+
+/**
+ * @brief Mix the active channels into the ring buffer until it is full, topping up the FIFO with
+ *        `zvb_sound_service` between each chunk. Nothing is mixed when all the channels are idle,
+ *        so the sample table voice doesn't use any CPU time in that case.
+ */
+void zvb_sound_mix_service(void);
@@ -0,0 +1,124 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_sound.h"
+#include "zvb_sound_fx.h"
+
+/**
+ * @brief Tick-driven music sequencer for the voices VOICE0 to VOICE3.
+ *
+ * A song is a dense binary blob, all values are little-endian:
+ *
+ *   Offset  Size   Description
+ *   0       3      Magic "ZSQ"
+ *   3       1      Version, must be SEQ_VERSION
+ *   4       1      Number of ticks per row, one tick per call to `zvb_sound_seq_tick`
+ *   5       1      Number of rows per pattern
+ *   6       1      Number of entries in the order table
+ *   7       1      Order entry to loop to at the end of the song, SEQ_NO_LOOP to stop
+ *   8       1      Number of entries in the note table
+ *   9       1      Number of patterns
+ *   10      2*N    Note table, each entry is a divider as returned by SOUND_FREQ_TO_DIV
+ *   ...     4*O    Order table, each entry contains the pattern index for VOICE0 to VOICE3,
+ *                  SEQ_NO_PATTERN leaves the voice silent
+ *   ...     2*P    Offset of each pattern from the beginning of the song
+ *   ...            Patterns data
+ *
+ * A pattern contains the events for a single voice, each event is one byte, optionally followed
+ * by a parameter byte:
+ *   0x00-0x7F      Play the note at this index in the note table for the current length
+ *   SEQ_REST       Mute the voice for the current length
+ *   SEQ_WAIT       Keep the current note for the current length
+ *   SEQ_LENGTH n   Set the current length to n rows (1-255)
+ *   SEQ_WAVE w     Set the waveform, a sound_waveform_t ORed with a sound_duty_cycle_t
+ *   SEQ_VOLUME v   Set the volume of the voice, a sound_volume_t
+ *   SEQ_INSTRUMENT i
+ *                  Play the next notes with the instrument i, from the table given to
+ *                  `zvb_sound_seq_set_instruments`, SEQ_NO_INSTRUMENT to go back to plain notes.
+ *                  Rests release the instrument notes instead of muting them.
+ *   SEQ_END        End of the pattern, the voice keeps its state until the next order entry
+ *
+ * The order table advances every `rows` rows, regardless of the patterns content.
+ */
+
+#define SEQ_VERSION     1
+#define SEQ_HEADER_SIZE 10
+#define SEQ_VOICES      4
+
+#define SEQ_NO_LOOP     0xff
+#define SEQ_NO_PATTERN  0xff
+#define SEQ_NO_INSTRUMENT 0xff
+
+#define SEQ_NOTE_MAX    0x7f
+#define SEQ_REST        0x80
+#define SEQ_WAIT        0x81
+#define SEQ_LENGTH      0x82
+#define SEQ_WAVE        0x83
+#define SEQ_VOLUME      0x84
+#define SEQ_INSTRUMENT  0x85
+#define SEQ_END         0xff
+
+#define SEQ_SUCCESS     0
+#define SEQ_INVALID     1
+
+
+/**
+ * @brief Header of a song, as stored in the binary
+ */
+typedef struct {
+    char     magic[3];
+    uint8_t  version;
+    uint8_t  speed;
+    uint8_t  rows;
+    uint8_t  order_len;
+    uint8_t  loop;
+    uint8_t  note_count;
+    uint8_t  pattern_count;
+} zvb_seq_header_t;
+
+
+/**
+ * @brief Start playing a song. The voices VOICE0 to VOICE3 are assigned to the sequencer,
+ *        the channels routing and the master volume are left untouched.
+ *
+ * @param song Song in the format described above, it must stay valid while it is being played
+ *
+ * @return SEQ_SUCCESS on success, SEQ_INVALID if the header is not valid
+ */
+uint8_t zvb_sound_seq_play(const void* song);
+
+
+/**
+ * @brief Set the instruments the SEQ_INSTRUMENT events refer to. When instruments are used,
+ *        `zvb_sound_fx_tick` must also be called once per frame, after `zvb_sound_seq_tick`.
+ *
+ * @param instruments Table of instruments, it must stay valid while the song is played
+ * @param count Number of instruments in the table
+ */
+void zvb_sound_seq_set_instruments(const zvb_fx_instrument_t* const* instruments, uint8_t count);
+
+
+/**
+ * @brief Stop the current song and hold all its voices.
+ */
+void zvb_sound_seq_stop(void);
+
+
+/**
+ * @brief Advance the current song by one tick, this function must be called once per frame,
+ *        typically right after the v-blank. Most ticks only decrement a counter, register writes
+ *        are only performed when a voice starts a new note or changes its settings.
+ */
+void zvb_sound_seq_tick(void);
+
+
+/**
+ * @brief Check whether a song is being played.
+ */
+uint8_t zvb_sound_seq_playing(void);
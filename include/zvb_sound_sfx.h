@@ -0,0 +1,84 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_sound.h"
+
+/**
+ * @brief Sound effects played on the voices VOICE0 to VOICE3, on top of the music. A voice playing
+ *        an effect is locked (see `zvb_sound_lock`), the music keeps running on it silently and
+ *        takes it back when the effect ends.
+ *
+ *        An effect is a script of steps, each step starts with a flags byte followed by the
+ *        values it changes, in this order:
+ *        - SFX_FREQ: 16-bit divider, little-endian (use SFX_DIV)
+ *        - SFX_WAVE: waveform ORed with a duty cycle
+ *        - SFX_VOL: sound_volume_t value
+ *        The step then lasts SFX_WAIT(n) ticks, 1 to 16, and the script ends after the step
+ *        flagged with SFX_END. For example, a short laser:
+ *
+ *        static const uint8_t laser[] = {
+ *            SFX_FREQ | SFX_WAVE | SFX_VOL | SFX_WAIT(2), SFX_DIV(1800), WAV_SQUARE, VOL_100,
+ *            SFX_FREQ | SFX_WAIT(2), SFX_DIV(1200),
+ *            SFX_FREQ | SFX_VOL | SFX_WAIT(4) | SFX_END, SFX_DIV(800), VOL_50,
+ *        };
+ */
+
+#define SFX_VOICES      4
+#define SFX_NO_VOICE    0xff
+
+#define SFX_FREQ        SOUND_WRITE_FREQ
+#define SFX_WAVE        SOUND_WRITE_WAVE
+#define SFX_VOL         SOUND_WRITE_VOL
+#define SFX_WAIT(n)     ((((n) - 1) & 0xf) << 3)
+#define SFX_END         0x80
+
+#define SFX_DIV(d)      ((uint8_t) (d)), ((uint8_t) ((d) >> 8))
+
+
+/**
+ * @brief Trigger a sound effect, it starts on the next call to `zvb_sound_sfx_tick`.
+ *        A voice is taken in this order: a voice silent in the music, any voice not playing an
+ *        effect, the voice playing the effect with the lowest priority, if not higher than the
+ *        given one. On equal priority, the effect triggered first is replaced. The cost doesn't
+ *        depend on the state, so it can be called from anywhere, including an interrupt handler,
+ *        the interrupt state is preserved.
+ *
+ * @param script Effect script, must stay valid while the effect is playing
+ * @param priority Priority of the effect, higher values win
+ * @param voices Voices allowed for this effect, the VOICE[0-3] values can be ORed
+ *
+ * @return Index of the voice playing the effect (0-3), SFX_NO_VOICE if none is available
+ */
+uint8_t zvb_sound_sfx_play(const uint8_t* script, uint8_t priority, sound_voice_t voices);
+
+
+/**
+ * @brief Stop the effect played on the given voice index, the voice returns to the music.
+ */
+void zvb_sound_sfx_stop(uint8_t voice);
+
+
+/**
+ * @brief Stop all the effects.
+ */
+void zvb_sound_sfx_stop_all(void);
+
+
+/**
+ * @brief Get the voices currently playing an effect, as a VOICE[0-3] mask.
+ */
+sound_voice_t zvb_sound_sfx_active(void);
+
+
+/**
+ * @brief Advance the effects by one step, must be called at a fixed rate, usually once per frame.
+ *        The voices of the effects that ended are given back to the music and the staged
+ *        changes are committed.
+ */
+void zvb_sound_sfx_tick(void);
@@ -0,0 +1,32 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <zos_vfs.h>
+#include "zvb_sound.h"
+
+
+/**
+ * @brief Play a raw or WAV file on the sample table voice, streaming it from the disk.
+ *        The file is read in chunks into a ring buffer made of two halves: one is fed to the FIFO
+ *        while the other is refilled. The function returns when the whole file has been played.
+ *
+ * @note Only mono PCM WAV files are supported, 8-bit or 16-bit. The FIFO can only be topped up
+ *       between two reads, so the time to read a chunk must stay below the FIFO duration
+ *       (256 bytes) at the chosen sample rate, else `zvb_sound_service` must also be called
+ *       from the v-blank handler.
+ *
+ * @param fd Opened file to read the samples from, the file is not closed by this function
+ * @param conf For raw files, sign, bit-width and sample rate divider of the samples.
+ *             For WAV files, filled with the values from the header.
+ *
+ * @return ERR_SUCCESS on success, ERR_NOT_SUPPORTED if the WAV format cannot be played,
+ *         including sample rates below 172Hz, which the divider cannot reach,
+ *         error returned by `read` else
+ */
+zos_err_t zvb_sound_stream_file(zos_dev_t fd, sound_samples_conf_t* conf);
@@ -0,0 +1,103 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_hardware.h"
+
+/**
+ * @brief Chip select lines of the SPI controller
+ */
+#define SPI_CS_TF       0
+
+/**
+ * @brief Get the clock divider for the given maximum frequency, in kHz. The output frequency is
+ *        50/(2*div) MHz, the result is rounded up so the frequency is never above the one given.
+ */
+#define SPI_DIV_FROM_KHZ(khz)   ((25000UL + (khz) - 1) / (khz))
+
+/* ~390kHz, below the 400kHz maximum allowed while initializing a TF card */
+#define SPI_CLK_DIV_SLOW        SPI_DIV_FROM_KHZ(400)
+/* 12.5MHz */
+#define SPI_CLK_DIV_FAST        2
+/* 25MHz, the maximum clock of TF cards in default speed mode */
+#define SPI_CLK_DIV_MIN         1
+
+/* Byte sent while receiving */
+#define SPI_FILL_BYTE           0xff
+
+
+/**
+ * @brief Initialize the SPI controller: reset it, set the clock divider and release the chip select.
+ *
+ * @note After calling this function, the peripheral will be mapped in the peripheral bank.
+ *
+ * @param clk_div Clock divider, the output frequency is 50/(2*clk_div) MHz
+ */
+void zvb_spi_initialize(uint8_t clk_div);
+
+
+/**
+ * @brief Set the clock divider, the output frequency is 50/(2*clk_div) MHz
+ */
+void zvb_spi_set_clk_div(uint8_t clk_div);
+
+
+/**
+ * @brief Get the current clock divider
+ */
+uint8_t zvb_spi_get_clk_div(void);
+
+
+/**
+ * @brief Assert (low) the given chip select line
+ *
+ * @param cs Chip select line, SPI_CS_TF for the TF card
+ */
+void zvb_spi_select(uint8_t cs);
+
+
+/**
+ * @brief Release (high) the chip select line
+ */
+void zvb_spi_deselect(void);
+
+
+/**
+ * @brief Exchange a single byte
+ *
+ * @return Byte received while sending the given one
+ */
+uint8_t zvb_spi_byte(uint8_t value);
+
+
+/**
+ * @brief Send and receive bytes at the same time, 8 bytes per transaction.
+ *
+ * @param tx Bytes to send (must NOT be NULL)
+ * @param rx Buffer to store the received bytes in, can be the same as tx (must NOT be NULL)
+ * @param length Number of bytes to exchange
+ */
+void zvb_spi_transfer(const uint8_t* tx, uint8_t* rx, uint16_t length);
+
+
+/**
+ * @brief Send bytes, the received bytes are discarded, 8 bytes per transaction.
+ *
+ * @param tx Bytes to send (must NOT be NULL)
+ * @param length Number of bytes to send
+ */
+void zvb_spi_send(const uint8_t* tx, uint16_t length);
+
+
+/**
+ * @brief Receive bytes while sending SPI_FILL_BYTE, 8 bytes per transaction.
+ *
+ * @param rx Buffer to store the received bytes in (must NOT be NULL)
+ * @param length Number of bytes to receive
+ */
+void zvb_spi_receive(uint8_t* rx, uint16_t length);
@@ -0,0 +1,118 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_hardware.h"
+
+/**
+ * @brief Direct output to the text controller, usable in text mode (640x480 or 320x240). The
+ *        characters are sent to the controller without going through the OS driver.
+ *
+ * @note The OS driver is not aware of the changes made by this library, mixing its output
+ *       (`printf`, `write`) with this library's may not continue at the expected position.
+ */
+
+/**
+ * @brief Build a color for `zvb_text_set_color`, the background and foreground are indexes in the
+ *        first 16 colors of the palette.
+ */
+#define TEXT_COLOR(bg, fg)  ((((bg) & 0xf) << 4) | ((fg) & 0xf))
+
+/**
+ * @brief Flags for `zvb_text_set_mode`
+ */
+#define TEXT_MODE_AUTO_SCROLL_X BIT(ZVB_PERI_TEXT_CTRL_AUTO_SCROLL_X_BIT)
+#define TEXT_MODE_AUTO_SCROLL_Y BIT(ZVB_PERI_TEXT_CTRL_AUTO_SCROLL_Y_BIT)
+#define TEXT_MODE_WAIT_ON_WRAP  BIT(ZVB_PERI_TEXT_CTRL_WAIT_ON_WRAP_BIT)
+#define TEXT_MODE_MASK          (TEXT_MODE_AUTO_SCROLL_X | TEXT_MODE_AUTO_SCROLL_Y | TEXT_MODE_WAIT_ON_WRAP)
+
+
+/**
+ * @brief Write characters at the cursor position, with the current color. The characters are
+ *        sent to the controller with `otir`, a `\n` moves the cursor to the beginning of the next
+ *        line, all the other bytes are printed from the font table.
+ *
+ * @note After calling this function, the peripheral will be mapped in the peripheral bank.
+ *
+ * @param buf Characters to write (must NOT be NULL)
+ * @param len Number of characters
+ */
+void zvb_text_write(const char* buf, uint16_t len);
+
+
+/**
+ * @brief Write a NULL-terminated string, same as `zvb_text_write`
+ */
+void zvb_text_print(const char* str);
+
+
+/**
+ * @brief Write a single character, same as `zvb_text_write`
+ */
+void zvb_text_put_char(char c);
+
+
+/**
+ * @brief Move the cursor to the beginning of the next line
+ */
+void zvb_text_newline(void);
+
+
+/**
+ * @brief Set the cursor position, in characters
+ */
+void zvb_text_set_cursor(uint8_t x, uint8_t y);
+
+
+/**
+ * @brief Get the cursor position, in characters
+ *
+ * @param x Filled with the column of the cursor (must NOT be NULL)
+ * @param y Filled with the line of the cursor (must NOT be NULL)
+ */
+void zvb_text_get_cursor(uint8_t* x, uint8_t* y);
+
+
+/**
+ * @brief Set the color of the next characters written, made with `TEXT_COLOR`
+ */
+void zvb_text_set_color(uint8_t color);
+
+
+/**
+ * @brief Get the color of the next characters written
+ */
+uint8_t zvb_text_get_color(void);
+
+
+/**
+ * @brief Set the scrolling and wrapping behavior of the cursor
+ *
+ * @param mode Combination of the TEXT_MODE_* flags
+ */
+void zvb_text_set_mode(uint8_t mode);
+
+
+/**
+ * @brief Get the scrolling and wrapping behavior of the cursor, combination of the TEXT_MODE_* flags
+ */
+uint8_t zvb_text_get_mode(void);
+
+
+/**
+ * @brief Save the cursor position and the current color. The position is saved by the controller
+ *        itself, only one save can be held at a time: saving again overwrites the previous one.
+ *        Useful to write a status line anywhere on screen and resume the output where it was.
+ */
+void zvb_text_save(void);
+
+
+/**
+ * @brief Restore the cursor position and the color saved by `zvb_text_save`
+ */
+void zvb_text_restore(void);
@@ -0,0 +1,113 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_spi.h"
+
+/**
+ * @brief Raw access to the TF card blocks, over the SPI controller, bypassing the file system.
+ *        This is part of the SPI library.
+ *
+ * @note The file system of the OS may be using the card too, make sure it is not accessing it
+ *       while this driver is used, and never write the blocks that belong to a mounted file system.
+ */
+
+typedef uint8_t tf_error;
+
+#define TF_SUCCESS          0
+#define TF_INVALID_ARG      1
+#define TF_NO_CARD          2   // The card didn't respond to the reset command
+#define TF_NOT_SUPPORTED    3   // The card is not an SD card or its voltage range is not supported
+#define TF_TIMEOUT          4   // The card didn't respond in time
+#define TF_READ_ERROR       5
+#define TF_WRITE_ERROR      6
+#define TF_CRC_ERROR        7   // The CRC of a received block is not valid
+
+#define TF_BLOCK_SIZE       512
+
+/* Clock negotiation: number of reads checked for each divider */
+#define TF_CLOCK_TEST_READS 8
+
+/* Types of card detected by `zvb_tf_init` */
+#define TF_TYPE_NONE        0
+#define TF_TYPE_SDV1        1   // SD version 1, byte addressing
+#define TF_TYPE_SDV2        2   // SD version 2 standard capacity, byte addressing
+#define TF_TYPE_SDHC        3   // SDHC or SDXC, block addressing
+
+
+/**
+ * @brief Initialize the card: reset it at low speed, negotiate its type and switch the SPI
+ *        controller to SPI_CLK_DIV_FAST.
+ */
+tf_error zvb_tf_init(void);
+
+
+/**
+ * @brief Get the type of the card, TF_TYPE_NONE if it was not initialized successfully.
+ */
+uint8_t zvb_tf_type(void);
+
+
+/**
+ * @brief Enable or disable the CRC check. When enabled, the card checks the CRC of all the
+ *        commands and written blocks, and the CRC of the received blocks is verified. This costs
+ *        around 3ms per block.
+ */
+tf_error zvb_tf_set_crc(uint8_t enable);
+
+
+/**
+ * @brief Find the fastest clock the card can be read reliably at. The given block is first read at
+ *        SPI_CLK_DIV_SLOW, then the divider is stepped down from 25 (1MHz) to SPI_CLK_DIV_MIN,
+ *        through 12, 8, 6, 5, 4, 3 and 2. At each step, the block is read TF_CLOCK_TEST_READS times
+ *        with the CRC check enabled and its content is compared to the first read, by CRC. The
+ *        negotiation stops at the first failure and the SPI controller is left at the last divider
+ *        that passed, or at SPI_CLK_DIV_SLOW if none did. The CRC check is restored to its
+ *        previous state.
+ *
+ * @note The block should not be empty, its content is what catches the bit errors.
+ *
+ * @param block Index of the block to read, it is not modified
+ * @param buffer Buffer of TF_BLOCK_SIZE bytes
+ * @param clk_div Filled with the divider chosen
+ */
+tf_error zvb_tf_negotiate_clock(uint32_t block, uint8_t* buffer, uint8_t* clk_div);
+
+
+/**
+ * @brief Read consecutive blocks into a buffer. Several blocks are read with a single multi-block
+ *        read command (CMD18).
+ *
+ * @param block Index of the first block to read
+ * @param buffer Buffer to read the blocks into, must be `count * TF_BLOCK_SIZE` bytes big
+ * @param count Number of blocks to read
+ */
+tf_error zvb_tf_read(uint32_t block, uint8_t* buffer, uint16_t count);
+
+
+/**
+ * @brief Read consecutive blocks into physical memory, such as VRAM, without any intermediate
+ *        copy. The memory is mapped in the virtual page 0, one block at a time, with the interrupts
+ *        disabled, their state is restored afterwards.
+ *
+ * @param block Index of the first block to read
+ * @param phys Physical address to read the blocks to
+ * @param count Number of blocks to read
+ */
+tf_error zvb_tf_read_phys(uint32_t block, uint32_t phys, uint16_t count);
+
+
+/**
+ * @brief Write consecutive blocks. Several blocks are written with a single multi-block write
+ *        command (CMD25).
+ *
+ * @param block Index of the first block to write
+ * @param buffer Content of the blocks, must be `count * TF_BLOCK_SIZE` bytes big
+ * @param count Number of blocks to write
+ */
+tf_error zvb_tf_write(uint32_t block, const uint8_t* buffer, uint16_t count);
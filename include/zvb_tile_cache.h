@@ -0,0 +1,91 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "zvb_gfx.h"
+
+/**
+ * @brief Cache of the tiles resident in VRAM, indexed by the CRC32 of their content. Loading a
+ *        tile that is already resident doesn't upload it again, the index of the resident copy
+ *        is returned instead. The tiles are hashed with the CRC peripheral, so the CRC32 library
+ *        must also be linked (ENABLE_CRC32=1).
+ *
+ * @note Two different tiles with the same CRC32 would be considered identical, this is very
+ *       unlikely but possible.
+ */
+
+#define TILE_CACHE_NO_SLOT  0xffff
+
+/**
+ * @brief Number of hash buckets, must be a power of 2
+ */
+#define TILE_CACHE_BUCKETS  64
+
+
+typedef struct {
+    uint32_t crc;
+    uint16_t next;  // Next entry in the same bucket, TILE_CACHE_NO_SLOT for none
+} gfx_tile_cache_entry;
+
+
+typedef struct {
+    gfx_tile_cache_entry* entries;  // One entry per slot, provided by the caller
+    uint16_t first;     // Index of the first tile managed by the cache
+    uint16_t count;     // Number of tiles managed by the cache
+    uint16_t used;      // Number of slots allocated, they are allocated in order
+    uint16_t tile_size; // Size of a tile in bytes, depends on the video mode
+    uint16_t hits;      // Number of uploads skipped
+    uint16_t misses;    // Number of uploads done
+    uint16_t buckets[TILE_CACHE_BUCKETS];
+} gfx_tile_cache;
+
+
+/**
+ * @brief Initialize a tile cache managing the tiles `first` to `first + count - 1`. The tiles
+ *        are 256 bytes big in 8bpp mode and 128 bytes in 4bpp mode.
+ *
+ * @param context Graphics context, must be initialized
+ * @param cache Cache to initialize
+ * @param entries Array of `count` entries, must stay valid while the cache is used
+ * @param first Index of the first tile slot
+ * @param count Number of tile slots
+ */
+gfx_error gfx_tile_cache_init(gfx_context* ctx, gfx_tile_cache* cache, gfx_tile_cache_entry* entries,
+                              uint16_t first, uint16_t count);
+
+
+/**
+ * @brief Forget all the tiles, the VRAM is not modified.
+ */
+void gfx_tile_cache_reset(gfx_tile_cache* cache);
+
+
+/**
+ * @brief Load an uncompressed tile, unless an identical one is already resident.
+ *
+ * @param context Graphics context, must be initialized
+ * @param cache Cache to load the tile in
+ * @param tile Content of the tile, the size depends on the video mode
+ *
+ * @return Index of the tile in the tileset, TILE_CACHE_NO_SLOT if the tile is not resident
+ *         and all the slots are used
+ */
+uint16_t gfx_tile_cache_load(gfx_context* ctx, gfx_tile_cache* cache, void* tile);
+
+
+/**
+ * @brief Get a mark that can be given to `gfx_tile_cache_release`, for example before loading the
+ *        tiles of a level, so that they can be released while keeping the common ones.
+ */
+uint16_t gfx_tile_cache_mark(const gfx_tile_cache* cache);
+
+
+/**
+ * @brief Release the slots allocated after the given mark, in constant time per slot.
+ */
+void gfx_tile_cache_release(gfx_tile_cache* cache, uint16_t mark);
@@ -22,6 +22,8 @@ ZOS_CFLAGS += $(ZVB_CFLAGS)
 ENABLE_GFX ?= 1
 ENABLE_SOUND ?= 0
 ENABLE_CRC32 ?= 0
+ENABLE_SPI ?= 0
+ENABLE_TEXT ?= 0
 
 # Make sure the whole program is relocated at 0x4000 as request by Zeal 8-bit OS.
 ZVB_LDFLAGS ?= -k $(ZVB_SDK_PATH)/lib/
@@ -38,8 +40,17 @@ ifeq ($(ENABLE_CRC32), 1)
 ZVB_LDFLAGS += -l zvb_crc
 endif
 
+# The DMA library relies on the CRC library to calibrate the controller
 ifeq ($(ENABLE_DMA), 1)
-ZVB_LDFLAGS += -l zvb_dma
+ZVB_LDFLAGS += -l zvb_dma -l zvb_crc
+endif
+
+ifeq ($(ENABLE_SPI), 1)
+ZVB_LDFLAGS += -l zvb_spi
+endif
+
+ifeq ($(ENABLE_TEXT), 1)
+ZVB_LDFLAGS += -l zvb_text
 endif
 
 ZOS_LDFLAGS += $(ZVB_LDFLAGS)
@@ -7,6 +7,18 @@
 #include <string.h>
 #include <stdint.h>
 #include "zvb_crc.h"
+#include "zvb_internal.h"
+
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+/**
+ * @brief Physical memory is mapped in page 0 to be fed to the peripheral. The interrupts are
+ *        disabled while it is mapped, so the windows are processed in chunks to keep the
+ *        interrupt latency low: 4KB take ~9ms with the `otir` loop.
+ */
+#define CRC_VIRT_WINDOW     ((uint8_t*) 0x0000)
+#define CRC_VIRT_PAGE_SIZE  (16*1024)
+#define CRC_PHYS_CHUNK_SIZE (4*1024)
 
 
 void zvb_crc_initialize(uint8_t reset)
@@ -68,3 +80,23 @@ __endasm;
     // Unreachable but prevents a warning
     return 0;
 }
+
+
+uint32_t zvb_crc_update_phys(uint32_t phys, uint32_t length)
+{
+    const uint8_t backup = mmu_page0_ro;
+
+    while (length) {
+        const uint16_t offset = (uint16_t) phys & (CRC_VIRT_PAGE_SIZE - 1);
+        const uint16_t part = MIN(length, MIN(CRC_PHYS_CHUNK_SIZE, CRC_VIRT_PAGE_SIZE - offset));
+
+        const uint8_t irq = zvb_mmu_map(phys);
+        zvb_crc_update(CRC_VIRT_WINDOW + offset, part);
+        zvb_mmu_demap(backup, irq);
+
+        phys += part;
+        length -= part;
+    }
+
+    return zvb_crc_update(NULL, 0);
+}
@@ -0,0 +1,104 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <zos_vfs.h>
+#include <zos_time.h>
+#include "zvb_crc_file.h"
+
+
+/**
+ * @brief Get the current time in milliseconds. The counter wraps around every ~65 seconds,
+ *        only the differences between two close calls are meaningful.
+ */
+static uint16_t zvb_crc_millis(void)
+{
+    zos_time_t time;
+
+    if (gettime(0, &time) != ERR_SUCCESS) {
+        return 0;
+    }
+    return time.t_millis;
+}
+
+
+/**
+ * @brief Fill the whole buffer, `read` may return fewer bytes than requested.
+ *
+ * @param size Size of the buffer, filled with the number of bytes read, 0 at the end of the file
+ */
+static zos_err_t zvb_crc_fill(zos_dev_t fd, uint8_t* buffer, uint16_t* size)
+{
+    uint16_t total = 0;
+
+    while (total < *size) {
+        uint16_t part = *size - total;
+        const zos_err_t err = read(fd, buffer + total, &part);
+        if (err != ERR_SUCCESS) {
+            return err;
+        }
+        if (part == 0) {
+            break;
+        }
+        total += part;
+    }
+
+    *size = total;
+    return ERR_SUCCESS;
+}
+
+
+zos_err_t zvb_crc_file(zos_dev_t fd, uint8_t* buffer, uint16_t size, uint32_t* crc, zvb_crc_stats_t* stats)
+{
+    uint32_t bytes = 0;
+    uint32_t read_ms = 0;
+    uint32_t crc_ms = 0;
+
+    if (buffer == NULL || size == 0 || crc == NULL) {
+        return ERR_INVALID_PARAMETER;
+    }
+
+    zvb_crc_initialize(1);
+    uint16_t start = zvb_crc_millis();
+    while (1) {
+        uint16_t length = size;
+        const zos_err_t err = zvb_crc_fill(fd, buffer, &length);
+        if (err != ERR_SUCCESS) {
+            return err;
+        }
+        const uint16_t read_end = zvb_crc_millis();
+        read_ms += (uint16_t) (read_end - start);
+
+        if (length == 0) {
+            break;
+        }
+        /* The peripheral is mapped again by each update, `read` may have changed the mapping */
+        zvb_crc_update(buffer, length);
+        bytes += length;
+
+        start = zvb_crc_millis();
+        crc_ms += (uint16_t) (start - read_end);
+    }
+    *crc = zvb_crc_update(buffer, 0);
+
+    if (stats != NULL) {
+        const uint32_t total_ms = read_ms + crc_ms;
+        stats->bytes = bytes;
+        stats->read_ms = read_ms;
+        stats->crc_ms = crc_ms;
+        /* Avoid overflowing the 32-bit multiplication for files bigger than 4MB */
+        if (total_ms == 0) {
+            stats->rate = 0;
+        } else if (bytes < 0x400000UL) {
+            stats->rate = bytes * 1000 / total_ms;
+        } else {
+            stats->rate = bytes / total_ms * 1000;
+        }
+    }
+
+    return ERR_SUCCESS;
+}
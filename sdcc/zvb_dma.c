@@ -1,6 +1,24 @@
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include "zvb_hardware.h"
 #include "zvb_dma.h"
+#include "zvb_crc.h"
+#include "zvb_internal.h"
+
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+/**
+ * @brief Physical memory will be mapped in page 0 when the CPU needs to access it
+ */
+#define DMA_VIRT_WINDOW     ((uint8_t*) 0x0000)
+
+/**
+ * @brief The raster counters follow the 640x480 VGA timings: 800 pixel clocks per line
+ *        and 525 lines per frame, blanking included
+ */
+#define RASTER_LINE_TICKS   800UL
+#define RASTER_FRAME_TICKS  (RASTER_LINE_TICKS * 525)
 
 uint32_t zvb_dma_virt_to_phys(void* ptr) __naked {
     (void*)ptr;
@@ -75,3 +93,534 @@ uint8_t zvb_dma_start_transfer(zvb_dma_descriptor_t *desc) {
 
     return 0; // ERR_SUCCESS
 }
+
+uint8_t zvb_dma_chain_init(zvb_dma_chain_t* chain, zvb_dma_descriptor_t* arena, uint8_t capacity) {
+    if (chain == NULL || arena == NULL || capacity == 0) {
+        return DMA_INVALID_ARG;
+    }
+
+    /* The controller fetches the descriptors sequentially in physical memory, make sure
+     * the arena doesn't cross a virtual page, which may not be contiguous physically */
+    const uint16_t first = (uint16_t) arena;
+    const uint16_t last = first + capacity * sizeof(zvb_dma_descriptor_t) - 1;
+    if (last < first || ((first ^ last) & 0xC000) != 0) {
+        return DMA_INVALID_ARG;
+    }
+
+    chain->descs = arena;
+    chain->capacity = capacity;
+    chain->count = 0;
+
+    return DMA_SUCCESS;
+}
+
+void zvb_dma_chain_reset(zvb_dma_chain_t* chain) {
+    chain->count = 0;
+}
+
+uint8_t zvb_dma_chain_add(zvb_dma_chain_t* chain, uint32_t rd_addr, uint32_t wr_addr, uint16_t length) {
+    if (chain->count == chain->capacity) {
+        return DMA_NO_SPACE;
+    }
+
+    zvb_dma_descriptor_t* desc = &chain->descs[chain->count];
+    zvb_dma_set_read(desc, rd_addr);
+    zvb_dma_set_write(desc, wr_addr);
+    desc->length = length;
+    desc->flags.raw = 0;
+    desc->flags.rd_op = ZVB_PERI_DMA_OP_INC;
+    desc->flags.wr_op = ZVB_PERI_DMA_OP_INC;
+    desc->flags.last = 1;
+
+    /* The previous descriptor is not the last one anymore */
+    if (chain->count != 0) {
+        desc[-1].flags.last = 0;
+    }
+    chain->count++;
+
+    return DMA_SUCCESS;
+}
+
+/**
+ * @brief Get the number of bytes, starting at the given virtual address, that belong to the same page
+ */
+static inline uint16_t zvb_dma_page_remaining(uint16_t virt) {
+    return DMA_VIRT_PAGE_SIZE - (virt & (DMA_VIRT_PAGE_SIZE - 1));
+}
+
+/**
+ * @brief Split a transfer at each virtual page boundary of its source and/or destination.
+ *        Each part is translated with the page it currently belongs to. When `emit` is 0,
+ *        the chain is not modified, the number of descriptors required is returned.
+ */
+static uint8_t zvb_dma_chain_split(zvb_dma_chain_t* chain,
+                                   uint16_t rd, uint8_t rd_virt,
+                                   uint16_t wr, uint8_t wr_virt,
+                                   uint32_t rd_phys, uint32_t wr_phys,
+                                   uint16_t length, uint8_t emit) {
+    uint8_t parts = 0;
+
+    while (length) {
+        uint16_t part = length;
+        if (rd_virt && zvb_dma_page_remaining(rd) < part) {
+            part = zvb_dma_page_remaining(rd);
+        }
+        if (wr_virt && zvb_dma_page_remaining(wr) < part) {
+            part = zvb_dma_page_remaining(wr);
+        }
+        if (emit) {
+            zvb_dma_chain_add(chain,
+                              rd_virt ? zvb_dma_virt_to_phys((void*) rd) : rd_phys,
+                              wr_virt ? zvb_dma_virt_to_phys((void*) wr) : wr_phys,
+                              part);
+        }
+        rd += part;
+        wr += part;
+        rd_phys += part;
+        wr_phys += part;
+        length -= part;
+        parts++;
+    }
+
+    return parts;
+}
+
+static uint8_t zvb_dma_chain_add_split(zvb_dma_chain_t* chain,
+                                       void* src, uint32_t rd_phys,
+                                       void* dst, uint32_t wr_phys,
+                                       uint16_t length) {
+    const uint16_t rd = (uint16_t) src;
+    const uint16_t wr = (uint16_t) dst;
+    const uint8_t rd_virt = src != NULL;
+    const uint8_t wr_virt = dst != NULL;
+
+    /* Count the number of descriptors required before modifying the chain */
+    const uint8_t parts = zvb_dma_chain_split(chain, rd, rd_virt, wr, wr_virt, rd_phys, wr_phys, length, 0);
+    if (chain->count + parts > chain->capacity) {
+        return DMA_NO_SPACE;
+    }
+    zvb_dma_chain_split(chain, rd, rd_virt, wr, wr_virt, rd_phys, wr_phys, length, 1);
+
+    return DMA_SUCCESS;
+}
+
+uint8_t zvb_dma_chain_add_virt(zvb_dma_chain_t* chain, void* src, uint32_t wr_addr, uint16_t length) {
+    if (src == NULL) {
+        return DMA_INVALID_ARG;
+    }
+    return zvb_dma_chain_add_split(chain, src, 0, NULL, wr_addr, length);
+}
+
+uint8_t zvb_dma_chain_add_to_virt(zvb_dma_chain_t* chain, uint32_t rd_addr, void* dst, uint16_t length) {
+    if (dst == NULL) {
+        return DMA_INVALID_ARG;
+    }
+    return zvb_dma_chain_add_split(chain, NULL, rd_addr, dst, 0, length);
+}
+
+uint8_t zvb_dma_chain_copy_virt(zvb_dma_chain_t* chain, void* dst, void* src, uint16_t length) {
+    if (dst == NULL || src == NULL) {
+        return DMA_INVALID_ARG;
+    }
+    return zvb_dma_chain_add_split(chain, src, 0, dst, 0, length);
+}
+
+/**
+ * @brief Fill the read or write address, and the length, of consecutive descriptors so that
+ *        each of them covers the part of the buffer that belongs to a single virtual page.
+ */
+static uint8_t zvb_dma_set_virt_len(zvb_dma_descriptor_t* desc, uint8_t count, void* ptr, uint16_t length, uint8_t write) {
+    uint16_t virt = (uint16_t) ptr;
+
+    if (desc == NULL || ptr == NULL || length == 0) {
+        return 0;
+    }
+    const uint8_t parts = (uint8_t) (((virt & (DMA_VIRT_PAGE_SIZE - 1)) + (uint32_t) length + DMA_VIRT_PAGE_SIZE - 1) >> 14);
+    if (parts > count) {
+        return 0;
+    }
+
+    while (length) {
+        uint16_t part = zvb_dma_page_remaining(virt);
+        if (part > length) {
+            part = length;
+        }
+        if (write) {
+            zvb_dma_set_write_virt(desc, (void*) virt);
+        } else {
+            zvb_dma_set_read_virt(desc, (void*) virt);
+        }
+        desc->length = part;
+        desc++;
+        virt += part;
+        length -= part;
+    }
+
+    return parts;
+}
+
+uint8_t zvb_dma_set_read_virt_len(zvb_dma_descriptor_t* desc, uint8_t count, void* ptr, uint16_t length) {
+    return zvb_dma_set_virt_len(desc, count, ptr, length, 0);
+}
+
+uint8_t zvb_dma_set_write_virt_len(zvb_dma_descriptor_t* desc, uint8_t count, void* ptr, uint16_t length) {
+    return zvb_dma_set_virt_len(desc, count, ptr, length, 1);
+}
+
+uint8_t zvb_dma_chain_start(zvb_dma_chain_t* chain) {
+    if (chain->count == 0) {
+        return DMA_INVALID_ARG;
+    }
+    return zvb_dma_start_transfer(chain->descs);
+}
+
+/**
+ * Transfer queue, the indexes are free-running, only the lowest bits are used to access the ring.
+ * Only `zvb_dma_queue_push` modifies the head and only `zvb_dma_service` modifies the tail, so the
+ * latter can safely be called from an interrupt handler.
+ * `s_dma_sync` is set while the library runs a chain synchronously, the queue is then left alone.
+ */
+static zvb_dma_chain_t* s_queue[DMA_QUEUE_SIZE];
+static volatile uint8_t s_queue_head;
+static volatile uint8_t s_queue_tail;
+static volatile uint8_t s_dma_sync;
+
+uint8_t zvb_dma_busy(void) {
+    zvb_map_peripheral(ZVB_PERI_DMA_IDX);
+    return (zvb_peri_dma_ctrl & ZVB_PERI_DMA_CTRL_BUSY) ? 1 : 0;
+}
+
+void zvb_dma_wait(void) {
+    while (zvb_dma_busy()) {
+    }
+}
+
+uint8_t zvb_dma_queue_push(zvb_dma_chain_t* chain) {
+    if (chain == NULL || chain->count == 0) {
+        return DMA_INVALID_ARG;
+    }
+    if ((uint8_t) (s_queue_head - s_queue_tail) == DMA_QUEUE_SIZE) {
+        return DMA_NO_SPACE;
+    }
+
+    s_queue[s_queue_head & (DMA_QUEUE_SIZE - 1)] = chain;
+    s_queue_head++;
+
+    /* Kick the transfer now if nothing is in progress */
+    zvb_dma_service();
+
+    return DMA_SUCCESS;
+}
+
+void zvb_dma_service(void) {
+    /* Called from the main program and from the interrupt handler, prevent both from
+     * starting the same chain */
+    const uint8_t irq = zvb_irq_save();
+
+    if (!s_dma_sync && s_queue_head != s_queue_tail) {
+        const uint8_t backup = zvb_config_dev_idx;
+        if (!zvb_dma_busy()) {
+            zvb_dma_chain_t* chain = s_queue[s_queue_tail & (DMA_QUEUE_SIZE - 1)];
+            s_queue_tail++;
+            zvb_dma_chain_start(chain);
+        }
+        zvb_map_peripheral(backup);
+    }
+
+    zvb_irq_restore(irq);
+}
+
+uint8_t zvb_dma_queue_pending(void) {
+    return s_queue_head - s_queue_tail;
+}
+
+void zvb_dma_queue_flush(void) {
+    while (zvb_dma_queue_pending() != 0) {
+        zvb_dma_service();
+    }
+    zvb_dma_wait();
+}
+
+/**
+ * @brief The second transfer reads the bytes it wrote `seed_len` bytes earlier. This is only valid
+ *        if the controller transfers one byte at a time, in increasing order, writing each byte
+ *        before reading the next one, see the note in `zvb_dma.h`.
+ */
+uint8_t zvb_dma_chain_fill(zvb_dma_chain_t* chain, uint32_t wr_addr, uint8_t value, uint16_t length) {
+    /* Use the reserved bytes of the first descriptor as the seed, they are part of the arena
+     * so they will still be valid when the controller processes the chain */
+    const uint16_t seed_len = sizeof(chain->descs->reserved);
+    const uint8_t needed = length <= seed_len ? 1 : 2;
+
+    if (length == 0) {
+        return DMA_SUCCESS;
+    }
+    if (chain->count + needed > chain->capacity) {
+        return DMA_NO_SPACE;
+    }
+
+    zvb_dma_descriptor_t* desc = &chain->descs[chain->count];
+    for (uint8_t i = 0; i < seed_len; i++) {
+        desc->reserved[i] = value;
+    }
+
+    if (length <= seed_len) {
+        return zvb_dma_chain_add(chain, zvb_dma_virt_to_phys(desc->reserved), wr_addr, length);
+    }
+    zvb_dma_chain_add(chain, zvb_dma_virt_to_phys(desc->reserved), wr_addr, seed_len);
+    return zvb_dma_chain_add(chain, wr_addr, wr_addr + seed_len, length - seed_len);
+}
+
+uint8_t zvb_dma_chain_pattern(zvb_dma_chain_t* chain, uint32_t wr_addr, void* pattern, uint16_t pattern_len, uint16_t length) {
+    if (pattern == NULL || pattern_len == 0) {
+        return DMA_INVALID_ARG;
+    }
+
+    if (length <= pattern_len) {
+        return zvb_dma_chain_add_virt(chain, pattern, wr_addr, length);
+    }
+
+    /* Make sure both parts fit before modifying the chain */
+    const uint8_t backup = chain->count;
+    uint8_t err = zvb_dma_chain_add_virt(chain, pattern, wr_addr, pattern_len);
+    if (err == DMA_SUCCESS) {
+        err = zvb_dma_chain_add(chain, wr_addr, wr_addr + pattern_len, length - pattern_len);
+    }
+    if (err != DMA_SUCCESS) {
+        chain->count = backup;
+        if (backup != 0) {
+            chain->descs[backup - 1].flags.last = 1;
+        }
+    }
+    return err;
+}
+
+
+static zvb_dma_clk_t s_clk;
+static uint16_t s_crossover = DMA_DEFAULT_CROSSOVER;
+
+/**
+ * @brief Arena used internally for the calibration, the benchmark and the copies
+ */
+static zvb_dma_descriptor_t s_arena[4];
+
+void zvb_dma_set_clock(zvb_dma_clk_t clk) {
+    s_clk = clk;
+    zvb_map_peripheral(ZVB_PERI_DMA_IDX);
+    zvb_peri_dma_clk_div = clk.raw;
+}
+
+zvb_dma_clk_t zvb_dma_get_clock(void) {
+    return s_clk;
+}
+
+/**
+ * @brief Calculate the CRC32 of a physical region with the CRC library
+ */
+static uint32_t zvb_dma_crc_phys(uint32_t addr, uint16_t length) {
+    zvb_crc_initialize(1);
+    return zvb_crc_update_phys(addr, length);
+}
+
+/**
+ * @brief Take the controller for synchronous transfers: wait for the queued chains to be transferred
+ *        and prevent `zvb_dma_service` from starting new ones until `zvb_dma_sync_end` is called.
+ */
+static void zvb_dma_sync_begin(void) {
+    zvb_dma_queue_flush();
+    s_dma_sync = 1;
+}
+
+/**
+ * @brief Give the controller back to the queue, start the chains pushed in the meantime, if any
+ */
+static void zvb_dma_sync_end(void) {
+    s_dma_sync = 0;
+    zvb_dma_service();
+}
+
+/**
+ * @brief Run the given chain and wait for it to finish, must be called between
+ *        `zvb_dma_sync_begin` and `zvb_dma_sync_end`
+ */
+static void zvb_dma_chain_run(zvb_dma_chain_t* chain) {
+    zvb_dma_chain_start(chain);
+    zvb_dma_wait();
+}
+
+/**
+ * @brief Test a clock setting: clear the destination with a value that doesn't match the source,
+ *        transfer the source and compare the checksums.
+ */
+static uint8_t zvb_dma_clock_passes(zvb_dma_chain_t* chain, uint8_t clk, uint32_t rd_addr, uint32_t wr_addr,
+                                    uint16_t length, uint32_t expected) {
+    zvb_dma_clk_t slowest = { .raw = 0xff };
+    zvb_dma_clk_t setting = { .raw = clk };
+
+    /* Try twice, with two different values, in case the source is filled with one of them */
+    for (uint8_t fill = 0; fill < 2; fill++) {
+        zvb_dma_set_clock(slowest);
+        zvb_dma_chain_reset(chain);
+        zvb_dma_chain_fill(chain, wr_addr, fill ? 0xff : 0x00, length);
+        zvb_dma_chain_run(chain);
+
+        zvb_dma_set_clock(setting);
+        zvb_dma_chain_reset(chain);
+        zvb_dma_chain_add(chain, rd_addr, wr_addr, length);
+        zvb_dma_chain_run(chain);
+
+        if (zvb_dma_crc_phys(wr_addr, length) != expected) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+uint8_t zvb_dma_calibrate(uint32_t rd_addr, uint32_t wr_addr, uint16_t length, zvb_dma_clk_t* result) {
+    zvb_dma_chain_t chain;
+    zvb_dma_clk_t best = { .raw = 0xff };
+
+    if (length == 0 || zvb_dma_chain_init(&chain, s_arena, 4) != DMA_SUCCESS) {
+        return DMA_INVALID_ARG;
+    }
+
+    const uint32_t expected = zvb_dma_crc_phys(rd_addr, length);
+
+    /* The clock is changed during the calibration, the queued transfers must not be affected */
+    zvb_dma_sync_begin();
+
+    /* Make sure the slowest setting works before looking for faster ones */
+    if (!zvb_dma_clock_passes(&chain, best.raw, rd_addr, wr_addr, length, expected)) {
+        zvb_dma_sync_end();
+        return DMA_FAILURE;
+    }
+
+    /* Reduce both the read and write cycles together first, then each of them separately */
+    for (uint8_t cycles = 14; cycles != 0xff; cycles--) {
+        const uint8_t clk = (cycles << 4) | cycles;
+        if (!zvb_dma_clock_passes(&chain, clk, rd_addr, wr_addr, length, expected)) {
+            break;
+        }
+        best.raw = clk;
+    }
+    while (best.rd_cycle != 0) {
+        zvb_dma_clk_t test = best;
+        test.rd_cycle--;
+        if (!zvb_dma_clock_passes(&chain, test.raw, rd_addr, wr_addr, length, expected)) {
+            break;
+        }
+        best = test;
+    }
+    while (best.wr_cycle != 0) {
+        zvb_dma_clk_t test = best;
+        test.wr_cycle--;
+        if (!zvb_dma_clock_passes(&chain, test.raw, rd_addr, wr_addr, length, expected)) {
+            break;
+        }
+        best = test;
+    }
+
+    zvb_dma_set_clock(best);
+    zvb_dma_sync_end();
+    if (result) {
+        *result = best;
+    }
+    return DMA_SUCCESS;
+}
+
+/**
+ * @brief Get the current raster position as a number of pixel clocks since the beginning of the frame
+ */
+static uint32_t zvb_dma_raster_ticks(void) {
+    /* The values are latched when the LSB is read */
+    const uint8_t vlow = zvb_ctrl_vpos_low;
+    const uint16_t vpos = (zvb_ctrl_vpos_high << 8) | vlow;
+    const uint8_t hlow = zvb_ctrl_hpos_low;
+    const uint16_t hpos = (zvb_ctrl_hpos_high << 8) | hlow;
+    return vpos * RASTER_LINE_TICKS + hpos;
+}
+
+static uint32_t zvb_dma_raster_elapsed(uint32_t start) {
+    const uint32_t now = zvb_dma_raster_ticks();
+    return (now >= start) ? now - start : now + RASTER_FRAME_TICKS - start;
+}
+
+/**
+ * @brief Copy a buffer to a physical address with the CPU, `memcpy` relies on `ldir`
+ */
+static void zvb_dma_cpu_copy(uint32_t wr_addr, uint8_t* src, uint16_t length) {
+    const uint8_t backup = mmu_page0_ro;
+
+    while (length) {
+        const uint16_t offset = (uint16_t) wr_addr & (DMA_VIRT_PAGE_SIZE - 1);
+        const uint16_t part = MIN(length, DMA_VIRT_PAGE_SIZE - offset);
+        const uint8_t irq = zvb_mmu_map(wr_addr);
+        memcpy(DMA_VIRT_WINDOW + offset, src, part);
+        zvb_mmu_demap(backup, irq);
+        wr_addr += part;
+        src += part;
+        length -= part;
+    }
+}
+
+uint16_t zvb_dma_benchmark(void* src, uint32_t wr_addr, uint16_t max_length) {
+    zvb_dma_chain_t chain;
+
+    if (src == NULL || zvb_dma_chain_init(&chain, s_arena, 4) != DMA_SUCCESS) {
+        return 0xffff;
+    }
+
+    zvb_dma_sync_begin();
+    s_crossover = 0xffff;
+    for (uint16_t size = 16; size != 0 && size <= max_length; size <<= 1) {
+        uint32_t start = zvb_dma_raster_ticks();
+        zvb_dma_cpu_copy(wr_addr, src, size);
+        const uint32_t cpu = zvb_dma_raster_elapsed(start);
+
+        /* Include the time needed to build the chain, as `zvb_dma_memcpy` would */
+        start = zvb_dma_raster_ticks();
+        zvb_dma_chain_reset(&chain);
+        if (zvb_dma_chain_add_virt(&chain, src, wr_addr, size) != DMA_SUCCESS) {
+            /* `zvb_dma_memcpy` would fall back to the CPU too */
+            break;
+        }
+        zvb_dma_chain_run(&chain);
+        const uint32_t dma = zvb_dma_raster_elapsed(start);
+
+        if (dma < cpu) {
+            s_crossover = size;
+            break;
+        }
+        /* The raster counters wrap around once per frame, the copies of the next size may
+         * take longer than a frame and could not be measured */
+        if (cpu >= RASTER_FRAME_TICKS / 2 || dma >= RASTER_FRAME_TICKS / 2) {
+            break;
+        }
+    }
+    zvb_dma_sync_end();
+
+    return s_crossover;
+}
+
+uint8_t zvb_dma_memcpy(uint32_t wr_addr, void* src, uint16_t length) {
+    zvb_dma_chain_t chain;
+
+    if (src == NULL) {
+        return DMA_INVALID_ARG;
+    }
+
+    if (length < s_crossover || zvb_dma_chain_init(&chain, s_arena, 4) != DMA_SUCCESS) {
+        zvb_dma_cpu_copy(wr_addr, src, length);
+        return DMA_SUCCESS;
+    }
+
+    /* The buffer may span more pages than the arena can describe, fall back to the CPU */
+    if (zvb_dma_chain_add_virt(&chain, src, wr_addr, length) != DMA_SUCCESS) {
+        zvb_dma_cpu_copy(wr_addr, src, length);
+        return DMA_SUCCESS;
+    }
+    zvb_dma_sync_begin();
+    zvb_dma_chain_run(&chain);
+    zvb_dma_sync_end();
+    return DMA_SUCCESS;
+}
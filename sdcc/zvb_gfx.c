@@ -7,6 +7,7 @@
 #include <string.h>
 #include <stdint.h>
 #include "zvb_gfx.h"
+#include "zvb_internal.h"
 
 /**
  * @brief VRAM will be mapped in page 0, which starts at address 0...
@@ -21,9 +22,6 @@
 
 #define MIN(a,b)  ((a) < (b) ? (a) : (b))
 
-/* Workaround to get the page 0 value from the MMU */
-const __sfr __banked __at(0xF0) mmu_page0_ro;
-__sfr __at(0xF0) mmu_page0;
 __sfr __banked __at(0x9d) vid_ctrl_status;
 
 /**
@@ -51,6 +49,101 @@ static inline void gfx_demap_vram(const uint8_t os)
     __asm__ ("ei");
 }
 
+
+#ifdef GFX_VERIFY
+
+/**
+ * @brief Verify mode: the bytes written to VRAM by the load functions are fed to the CRC
+ *        peripheral, the written range is then read back through the CRC peripheral and both
+ *        checksums are compared. Enabled by building the library with GFX_VERIFY defined.
+ */
+static void gfx_verify_start(void)
+{
+    zvb_map_peripheral(ZVB_PERI_CRC_IDX);
+    zvb_peri_crc_ctrl = BIT(IO_CRC32_CTRL_RESET_BIT);
+}
+
+
+#define gfx_verify_byte(b)  do { zvb_peri_crc_data_in = (b); } while (0)
+
+
+static void gfx_verify_feed(const void* data, uint16_t size) __naked __sdcccall(1)
+{
+    (void) data;
+    (void) size;
+__asm
+    ; Data in HL, size in DE
+    ld a, d
+    or e
+    ret z
+    ; Same as `zvb_crc_update`, use OTIR on 256-byte blocks, round the number of blocks up
+    ld a, d
+    ld b, e
+    dec b
+    inc b
+    jr z, gfx_verify_feed_no_add
+    inc a
+gfx_verify_feed_no_add:
+    ld c, # ZVB_PERI_BASE + 0x1
+gfx_verify_feed_loop:
+    otir
+    dec a
+    jp nz, gfx_verify_feed_loop
+    ret
+__endasm;
+}
+
+
+static uint32_t gfx_verify_result(void)
+{
+    uint32_t crc = zvb_peri_crc_byte3;
+    crc = (crc << 8) | zvb_peri_crc_byte2;
+    crc = (crc << 8) | zvb_peri_crc_byte1;
+    crc = (crc << 8) | zvb_peri_crc_byte0;
+    return crc;
+}
+
+
+/**
+ * @brief Read back the given VRAM range and compare its checksum with the one of the bytes fed
+ *        since `gfx_verify_start`.
+ *
+ * @param page Physical page (16KB) the range starts in
+ * @param offset Offset of the range in the page, can be bigger than a page
+ * @param length Length of the range in bytes
+ */
+static gfx_error gfx_verify_range(gfx_context* ctx, uint8_t page, uint16_t offset, uint32_t length)
+{
+    const uint32_t expected = gfx_verify_result();
+
+    page += offset >> 14;
+    offset &= 16*1024 - 1;
+    zvb_peri_crc_ctrl = BIT(IO_CRC32_CTRL_RESET_BIT);
+    while (length) {
+        const uint16_t part = MIN(length, 16*1024 - offset);
+        __asm__ ("di");
+        mmu_page0 = page++;
+        gfx_verify_feed((uint8_t*) VRAM_VIRT_ADDR + offset, part);
+        gfx_demap_vram(ctx->backup_page);
+        length -= part;
+        offset = 0;
+    }
+
+    return gfx_verify_result() == expected ? GFX_SUCCESS : GFX_VERIFY_FAILED;
+}
+
+#else
+
+#define gfx_verify_start()
+#define gfx_verify_byte(b)
+#define gfx_verify_feed(data, size)
+#define gfx_verify_range(ctx, page, offset, length)  (GFX_SUCCESS)
+
+#endif // GFX_VERIFY
+
+#define TILESET_PAGE    (VID_MEM_TILESET_ADDR >> 14)
+#define VRAM_PAGE       (VID_MEM_PHYS_ADDR_START >> 14)
+
 static void memset_vram(void* ptr, int a, uint16_t size) __naked
 {
     (void) ptr;
@@ -124,10 +217,13 @@ gfx_error gfx_palette_load(gfx_context* ctx, void* palette, uint16_t size, uint8
 
     uint16_t* vram_palette = (uint16_t*) (VRAM_VIRT_ADDR + VID_MEM_PALETTE_OFFSET);
 
+    gfx_verify_start();
+    gfx_verify_feed(palette, size);
+
     gfx_map_vram();
     memcpy(&vram_palette[from], palette, size);
     gfx_demap_vram(ctx->backup_page);
-    return GFX_SUCCESS;
+    return gfx_verify_range(ctx, VRAM_PAGE, VID_MEM_PALETTE_OFFSET + from * 2, size);
 }
 
 
@@ -138,14 +234,21 @@ static gfx_error gfx_tileset_load_bitmap(gfx_context* ctx, uint8_t* tileset, uin
     gfx_map_tileset(page);
     uint8_t* vram_tileset = (uint8_t*) (VRAM_VIRT_ADDR + from_byte);
     const uint8_t bpp = ctx->bpp;
+#ifdef GFX_VERIFY
+    /* Number of bytes written to VRAM, `size` is consumed by the loop */
+    const uint32_t length = (uint32_t) size * bpp;
+#endif
 
+    gfx_verify_start();
     while (size--) {
         uint8_t byte = *tileset++;
 
         if (bpp == 8) {
             /* If the current mode is 256-color, one bit must be converted to one byte */
             for (uint8_t i = 0; i < 8; i++) {
-                *vram_tileset++ = pal_offset + ((byte & 0x80) ? 1 : 0);
+                const uint8_t pix = pal_offset + ((byte & 0x80) ? 1 : 0);
+                *vram_tileset++ = pix;
+                gfx_verify_byte(pix);
                 byte = byte << 1;
             }
         } else {
@@ -153,13 +256,15 @@ static gfx_error gfx_tileset_load_bitmap(gfx_context* ctx, uint8_t* tileset, uin
             for (uint8_t i = 0; i < 4; i++) {
                 const uint8_t left_pix  = pal_offset + ((byte & 0x80) ? 1 : 0);
                 const uint8_t right_pix = pal_offset + ((byte & 0x40) ? 1 : 0);
-                *vram_tileset++ = ((left_pix  & 0xf) << 4) |
-                                   (right_pix & 0xf);
+                const uint8_t pix = ((left_pix  & 0xf) << 4) |
+                                     (right_pix & 0xf);
+                *vram_tileset++ = pix;
+                gfx_verify_byte(pix);
                 byte = byte << 2;
             }
         }
         /* Each we reached the end of the page, start all over again */
-        if ((uintptr_t) vram_tileset & (16*1024) != 0) {
+        if (((uintptr_t) vram_tileset & (16*1024)) != 0) {
             gfx_map_tileset(++page);
             vram_tileset = VRAM_VIRT_ADDR;
         }
@@ -167,7 +272,7 @@ static gfx_error gfx_tileset_load_bitmap(gfx_context* ctx, uint8_t* tileset, uin
 
     gfx_demap_vram(ctx->backup_page);
 
-    return GFX_SUCCESS;
+    return gfx_verify_range(ctx, TILESET_PAGE, from, length);
 }
 
 
@@ -179,8 +284,13 @@ static gfx_error gfx_tileset_load_2bit(gfx_context* ctx, uint8_t* tileset, uint1
     gfx_map_tileset(page);
     uint8_t* vram_tileset = (uint8_t*) (VRAM_VIRT_ADDR + from_byte);
     const uint8_t bpp = ctx->bpp;
+#ifdef GFX_VERIFY
+    /* Number of bytes written to VRAM, `size` is consumed by the loop */
+    const uint32_t length = (uint32_t) size * (bpp / 2);
+#endif
     (void) opacity;
 
+    gfx_verify_start();
     while (size--) {
         uint8_t byte = *tileset++;
 
@@ -190,16 +300,28 @@ static gfx_error gfx_tileset_load_2bit(gfx_context* ctx, uint8_t* tileset, uint1
         const uint8_t pix_0 = pal_offset + ((byte >> 6) & 3);
 
         if (bpp == 8) {
-            *vram_tileset++ = (opacity && pix_0 == pal_offset) ? 0 : pix_0;
-            *vram_tileset++ = (opacity && pix_1 == pal_offset) ? 0 : pix_1;
-            *vram_tileset++ = (opacity && pix_2 == pal_offset) ? 0 : pix_2;
-            *vram_tileset++ = (opacity && pix_3 == pal_offset) ? 0 : pix_3;
+            const uint8_t out_0 = (opacity && pix_0 == pal_offset) ? 0 : pix_0;
+            const uint8_t out_1 = (opacity && pix_1 == pal_offset) ? 0 : pix_1;
+            const uint8_t out_2 = (opacity && pix_2 == pal_offset) ? 0 : pix_2;
+            const uint8_t out_3 = (opacity && pix_3 == pal_offset) ? 0 : pix_3;
+            *vram_tileset++ = out_0;
+            *vram_tileset++ = out_1;
+            *vram_tileset++ = out_2;
+            *vram_tileset++ = out_3;
+            gfx_verify_byte(out_0);
+            gfx_verify_byte(out_1);
+            gfx_verify_byte(out_2);
+            gfx_verify_byte(out_3);
         } else {
-            *vram_tileset++ = ((pix_0 & 0xf) << 4) | (pix_1 & 0xf);
-            *vram_tileset++ = ((pix_2 & 0xf) << 4) | (pix_3 & 0xf);
+            const uint8_t out_0 = ((pix_0 & 0xf) << 4) | (pix_1 & 0xf);
+            const uint8_t out_1 = ((pix_2 & 0xf) << 4) | (pix_3 & 0xf);
+            *vram_tileset++ = out_0;
+            *vram_tileset++ = out_1;
+            gfx_verify_byte(out_0);
+            gfx_verify_byte(out_1);
         }
         /* Each we reached the end of the page, start all over again */
-        if ((uintptr_t) vram_tileset & (16*1024) != 0) {
+        if (((uintptr_t) vram_tileset & (16*1024)) != 0) {
             gfx_map_tileset(++page);
             vram_tileset = VRAM_VIRT_ADDR;
         }
@@ -207,7 +329,7 @@ static gfx_error gfx_tileset_load_2bit(gfx_context* ctx, uint8_t* tileset, uint1
 
     gfx_demap_vram(ctx->backup_page);
 
-    return GFX_SUCCESS;
+    return gfx_verify_range(ctx, TILESET_PAGE, from, length);
 }
 
 
@@ -219,6 +341,7 @@ static gfx_error gfx_tileset_load_nibble(gfx_context* ctx, uint8_t* tileset, uin
     gfx_map_tileset(page);
     uint8_t* vram_tileset = (uint8_t*) (VRAM_VIRT_ADDR + from_byte);
 
+    gfx_verify_start();
     while (remaining) {
         const uint8_t byte = *tileset;
         uint8_t high = (byte >> 4) + pal_offset;
@@ -233,10 +356,12 @@ static gfx_error gfx_tileset_load_nibble(gfx_context* ctx, uint8_t* tileset, uin
         vram_tileset++;
         *vram_tileset = low;
         vram_tileset++;
+        gfx_verify_byte(high);
+        gfx_verify_byte(low);
         tileset++;
         remaining--;
         /* Each we reached the end of the page, start all over again */
-        if ((uintptr_t) vram_tileset & (16*1024) != 0) {
+        if (((uintptr_t) vram_tileset & (16*1024)) != 0) {
             gfx_map_tileset(++page);
             vram_tileset = VRAM_VIRT_ADDR;
         }
@@ -244,7 +369,7 @@ static gfx_error gfx_tileset_load_nibble(gfx_context* ctx, uint8_t* tileset, uin
 
     gfx_demap_vram(ctx->backup_page);
 
-    return GFX_SUCCESS;
+    return gfx_verify_range(ctx, TILESET_PAGE, from, (uint32_t) size * 2);
 }
 
 static gfx_error gfx_tileset_load_rle(gfx_context* ctx, uint8_t* data, uint16_t size, uint16_t from, uint8_t pal_offset, uint8_t opacity) {
@@ -280,7 +405,10 @@ static gfx_error gfx_tileset_load_rle(gfx_context* ctx, uint8_t* data, uint16_t
                 .pal_offset = pal_offset, // copy over
                 .opacity = opacity, // copy over
             };
-            gfx_tileset_load(ctx, &buffer, TILE_SIZE_8BIT,  &options);
+            const gfx_error err = gfx_tileset_load(ctx, &buffer, TILE_SIZE_8BIT,  &options);
+            if (err != GFX_SUCCESS) {
+                return err;
+            }
             tile_count++;
             j = 0;
         }
@@ -298,12 +426,14 @@ void memaddcpy(uint8_t* dst, uint8_t* src, size_t size, uint8_t opacity, uint8_t
                 byte = 0;
             }
             *dst = byte;
+            gfx_verify_byte(byte);
             src++;
             dst++;
             size--;
         }
     } else {
         memcpy(dst, src, size);
+        gfx_verify_feed(src, size);
     }
 }
 
@@ -341,6 +471,7 @@ gfx_error gfx_tileset_load(gfx_context* ctx, void* tileset, uint16_t size, const
         uint8_t  page = from / (16*1024);
         uint16_t from_byte = from % (16*1024);
         uint16_t remaining = size;
+        gfx_verify_start();
         while (remaining) {
             /* Maximum number of bytes that can be copied in the current page */
             size_t can_copy = 16*1024 - from_byte;
@@ -353,6 +484,7 @@ gfx_error gfx_tileset_load(gfx_context* ctx, void* tileset, uint16_t size, const
         }
 
         gfx_demap_vram(ctx->backup_page);
+        return gfx_verify_range(ctx, TILESET_PAGE, from, size);
     }
     return GFX_SUCCESS;
 }
@@ -395,11 +527,13 @@ gfx_error gfx_tilemap_load(gfx_context* ctx, void* tiles, uint8_t size, uint8_t
     uint16_t layer_offset = layer != 0 ? VID_MEM_LAYER1_OFFSET : 0;
     uint16_t position = y * (MAX_COL + 1) + x;
     uint8_t* vram_tilemap = (uint8_t*) (VRAM_VIRT_ADDR + layer_offset + position);
+    gfx_verify_start();
+    gfx_verify_feed(tiles, size);
     gfx_map_vram();
     memcpy(vram_tilemap, tiles, size);
     gfx_demap_vram(ctx->backup_page);
 
-    return GFX_SUCCESS;
+    return gfx_verify_range(ctx, VRAM_PAGE, layer_offset + position, size);
 }
 
 
@@ -0,0 +1,123 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Helpers shared by the libraries sources, not part of the API.
+ */
+
+
+#ifdef ZVB_HOST
+
+/**
+ * @brief Host builds of the sources, such as the TF card simulator in `tools/tf_sim`: there are
+ *        no interrupts and the page 0 window points to the physical memory emulated by the host
+ *        program, which must define `zvb_host_page0` and `zvb_host_phys_page`.
+ */
+extern uint8_t* zvb_host_page0;
+uint8_t* zvb_host_phys_page(uint8_t page);
+
+#define ZVB_PAGE0_WINDOW    zvb_host_page0
+#define mmu_page0_ro        0
+
+static inline uint8_t zvb_irq_save(void)
+{
+    return 0;
+}
+
+static inline void zvb_irq_restore(uint8_t state)
+{
+    (void) state;
+}
+
+static inline uint8_t zvb_mmu_map(uint32_t phys)
+{
+    zvb_host_page0 = zvb_host_phys_page((uint8_t) (phys >> 14));
+    return 0;
+}
+
+static inline void zvb_mmu_demap(uint8_t backup, uint8_t irq)
+{
+    (void) backup;
+    (void) irq;
+    zvb_host_page0 = NULL;
+}
+
+#else
+
+/**
+ * @brief Virtual address of the page 0, where `zvb_mmu_map` maps the physical memory
+ */
+#define ZVB_PAGE0_WINDOW    ((uint8_t*) 0x0000)
+
+/**
+ * @brief Disable the interrupts and return their previous state, to pass to `zvb_irq_restore`.
+ *        Unlike a plain `di`/`ei` pair, this can be used by code that may run with the interrupts
+ *        already disabled, such as an interrupt handler. `ld a, i` copies IFF2 to the P/V flag.
+ */
+static uint8_t zvb_irq_save(void) __naked __sdcccall(1)
+{
+__asm
+    ld a, i
+    di
+    ld a, # 0
+    ret po
+    inc a
+    ret
+__endasm;
+}
+
+
+/**
+ * @brief Re-enable the interrupts only if they were enabled when `zvb_irq_save` was called
+ */
+static void zvb_irq_restore(uint8_t state) __naked __sdcccall(1)
+{
+    (void) state;
+__asm
+    ; State in A
+    or a
+    ret z
+    ei
+    ret
+__endasm;
+}
+
+
+/* Workaround to get the page 0 value from the MMU */
+const __sfr __banked __at(0xF0) mmu_page0_ro;
+__sfr __at(0xF0) mmu_page0;
+
+
+/**
+ * @brief Map the 16KB physical page containing the given address in the virtual page 0, with the
+ *        interrupts disabled since their handler may be located there. The caller's code and data
+ *        must not be located in page 0.
+ *
+ * @return Interrupt state to give to `zvb_mmu_demap`
+ */
+static inline uint8_t zvb_mmu_map(uint32_t phys)
+{
+    const uint8_t irq = zvb_irq_save();
+    mmu_page0 = (uint8_t) (phys >> 14);
+    return irq;
+}
+
+
+/**
+ * @brief Map back the page saved from `mmu_page0_ro` and restore the interrupt state
+ */
+static inline void zvb_mmu_demap(uint8_t backup, uint8_t irq)
+{
+    mmu_page0 = backup;
+    zvb_irq_restore(irq);
+}
+
+#endif // ZVB_HOST
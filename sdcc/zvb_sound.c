@@ -7,22 +7,112 @@
 #include <string.h>
 #include <stdint.h>
 #include "zvb_sound.h"
+#include "zvb_internal.h"
 
 #define BIT(n)  (1 << (n))
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+#define SHADOW_VOICES       4
+#define SHADOW_VOICES_MASK  (VOICE0 | VOICE1 | VOICE2 | VOICE3)
 
 static uint8_t s_mst_hold;
 
+/**
+ * Shadow of the registers, most of them are write-only. The shadow is updated before the register
+ * itself so that the service routine can restore the selected voices if it interrupts a write sequence.
+ * The `s_hw_*_known` values mark the registers, or the voices, whose value is known.
+ */
+static uint8_t s_hw_select;
+static uint8_t s_hw_hold;
+static uint16_t s_hw_freq[SHADOW_VOICES];
+static uint8_t s_hw_wave[SHADOW_VOICES];
+static uint8_t s_hw_vol[SHADOW_VOICES];
+static uint8_t s_hw_freq_known;
+static uint8_t s_hw_wave_known;
+static uint8_t s_hw_vol_known;
+static uint8_t s_hw_left;
+static uint8_t s_hw_right;
+static uint8_t s_hw_master;
+static uint8_t s_hw_hold_known;
+static uint8_t s_hw_channels_known;
+static uint8_t s_hw_master_known;
+
+/* Values staged by the `zvb_sound_stage_*` functions, written on the next commit */
+static uint16_t s_freq[SHADOW_VOICES];
+static uint8_t s_wave[SHADOW_VOICES];
+static uint8_t s_vol[SHADOW_VOICES];
+static uint8_t s_dirty_freq;
+static uint8_t s_dirty_wave;
+static uint8_t s_dirty_vol;
+static uint8_t s_dirty_hold;
+
+/* Voices locked by `zvb_sound_lock`, their staged values are kept until they are unlocked */
+static uint8_t s_locked;
+static uint8_t s_lock_hold;
+
+/* Asynchronous playback ring buffer, the counter is shared with the service routine */
+static uint8_t* s_ring;
+static uint16_t s_ring_size;
+static uint16_t s_ring_rd;
+static uint16_t s_ring_wr;
+static volatile uint16_t s_ring_count;
+static uint8_t s_async_ended;
+static volatile sound_async_status_t s_async_status;
+
 static inline void zvb_sound_map(void)
 {
     zvb_map_peripheral(ZVB_PERI_SOUND_IDX);
 }
 
+
+static void zvb_sound_select(uint8_t voices)
+{
+    if (s_hw_select != voices) {
+        s_hw_select = voices;
+        zvb_peri_sound_select = voices;
+    }
+}
+
+
+/**
+ * @brief Write the hold register from the master hold value, the sample table voice is kept
+ *        running while an asynchronous playback is in progress.
+ */
+static void zvb_sound_update_hold(void)
+{
+    uint8_t hold = (s_mst_hold & ~s_locked) | (s_lock_hold & s_locked);
+    if (s_async_status != SOUND_ASYNC_STOPPED) {
+        hold &= ~SAMPTAB;
+    }
+    if (!s_hw_hold_known || s_hw_hold != hold) {
+        s_hw_hold = hold;
+        s_hw_hold_known = 1;
+        zvb_peri_sound_hold = hold;
+    }
+}
+
+
 void zvb_sound_initialize(uint8_t reset)
 {
     zvb_sound_map();
+    /* The registers may have been modified by another program, forget the shadow */
+    s_hw_select = zvb_peri_sound_select;
+    s_hw_hold_known = 0;
+    s_hw_freq_known = 0;
+    s_hw_wave_known = 0;
+    s_hw_vol_known = 0;
+    s_hw_channels_known = 0;
+    s_hw_master_known = 0;
+    s_dirty_freq = 0;
+    s_dirty_wave = 0;
+    s_dirty_vol = 0;
+    s_dirty_hold = 0;
+    s_locked = 0;
+
     if (reset) {
-        zvb_peri_sound_select = VOICE0 | VOICE1 | VOICE2 | VOICE3;
-        zvb_peri_sound_hold = 0xff;
+        zvb_sound_select(VOICE0 | VOICE1 | VOICE2 | VOICE3);
+        s_mst_hold = 0xff;
+        zvb_sound_update_hold();
 
         /* By default, set both channels volume to 100% and assign all voices to both channels */
         zvb_peri_sound_volume = ZVB_PERI_SOUND_VOL_100;
@@ -30,7 +120,16 @@ void zvb_sound_initialize(uint8_t reset)
         zvb_peri_sound_right_channel = VOICE0 | VOICE1 | VOICE2 | VOICE3;
         zvb_peri_sound_master_vol = ZVB_PERI_SOUND_VOL_DISABLE;
 
-        zvb_peri_sound_select = 0;
+        for (uint8_t i = 0; i < SHADOW_VOICES; i++) {
+            s_hw_vol[i] = s_vol[i] = ZVB_PERI_SOUND_VOL_100;
+        }
+        s_hw_vol_known = SHADOW_VOICES_MASK;
+        s_hw_left = s_hw_right = VOICE0 | VOICE1 | VOICE2 | VOICE3;
+        s_hw_master = ZVB_PERI_SOUND_VOL_DISABLE;
+        s_hw_channels_known = 1;
+        s_hw_master_known = 1;
+
+        zvb_sound_select(0);
     }
 }
 
@@ -41,40 +140,258 @@ void zvb_sound_reset(void)
 }
 
 
-void zvb_sound_set_voices(sound_voice_t voices, uint16_t divider, sound_waveform_t waveform)
+void zvb_sound_stage_freq(sound_voice_t voices, uint16_t divider)
 {
-    zvb_sound_map();
+    for (uint8_t i = 0; i < SHADOW_VOICES; i++) {
+        if (voices & BIT(i)) {
+            s_freq[i] = divider;
+        }
+    }
+    s_dirty_freq |= voices & SHADOW_VOICES_MASK;
+}
 
-    /* Temporarily hold the voices */
-    zvb_peri_sound_hold = s_mst_hold | voices;
 
-    /* Map the voices */
-    zvb_peri_sound_select = voices;
-    /* Set the divider and the waveform */
-    zvb_peri_sound_freq_low  = divider & 0xff;
-    zvb_peri_sound_freq_high = (divider >> 8) & 0xff;
-    zvb_peri_sound_wave = waveform;
-    /* Unhold the voices if they were unhold before the call */
-    zvb_peri_sound_hold = s_mst_hold;
+void zvb_sound_stage_wave(sound_voice_t voices, uint8_t waveform)
+{
+    for (uint8_t i = 0; i < SHADOW_VOICES; i++) {
+        if (voices & BIT(i)) {
+            s_wave[i] = waveform;
+        }
+    }
+    s_dirty_wave |= voices & SHADOW_VOICES_MASK;
 }
 
-void zvb_sound_set_voices_vol(sound_voice_t voices, sound_volume_t vol)
+
+void zvb_sound_stage_vol(sound_voice_t voices, sound_volume_t vol)
 {
-    zvb_sound_map();
-    zvb_peri_sound_select = voices;
-    zvb_peri_sound_volume = vol;
+    for (uint8_t i = 0; i < SHADOW_VOICES; i++) {
+        if (voices & BIT(i)) {
+            s_vol[i] = vol;
+        }
+    }
+    s_dirty_vol |= voices & SHADOW_VOICES_MASK;
 }
 
 
-void zvb_sound_set_hold(sound_voice_t voices, uint8_t hold)
+void zvb_sound_stage_hold(sound_voice_t voices, uint8_t hold)
 {
-    zvb_sound_map();
     if (hold == 0) {
         s_mst_hold &= ~voices;
     } else {
         s_mst_hold |= voices;
     }
-    zvb_peri_sound_hold = s_mst_hold;
+    s_dirty_hold = 1;
+}
+
+
+/**
+ * @brief Get the value of a voice from a shadow array, `width` is the size of its elements:
+ *        2 for the dividers, 1 for the other registers
+ */
+static uint16_t zvb_sound_shadow_get(const void* array, uint8_t i, uint8_t width)
+{
+    return (width == 2) ? ((const uint16_t*) array)[i] : ((const uint8_t*) array)[i];
+}
+
+
+/**
+ * @brief Get the voices, among `pending`, that are staged with the same value as the first one
+ *        and whose register doesn't already contain that value. The first voice is removed from
+ *        `pending` along with all the voices having the same value.
+ */
+static uint8_t zvb_sound_group(uint8_t* pending, const void* staged, const void* hw, uint8_t known, uint8_t width)
+{
+    uint8_t i = 0;
+    while ((*pending & BIT(i)) == 0) {
+        i++;
+    }
+    const uint16_t value = zvb_sound_shadow_get(staged, i, width);
+    uint8_t group = 0;
+    uint8_t same = 0;
+    for (; i < SHADOW_VOICES; i++) {
+        if ((*pending & BIT(i)) && zvb_sound_shadow_get(staged, i, width) == value) {
+            same |= BIT(i);
+            if ((known & BIT(i)) == 0 || zvb_sound_shadow_get(hw, i, width) != value) {
+                group |= BIT(i);
+            }
+        }
+    }
+    *pending &= ~same;
+    return group;
+}
+
+
+static void zvb_sound_update_shadow(uint8_t group, void* hw, uint16_t value, uint8_t width)
+{
+    for (uint8_t i = 0; i < SHADOW_VOICES; i++) {
+        if (group & BIT(i)) {
+            if (width == 2) {
+                ((uint16_t*) hw)[i] = value;
+            } else {
+                ((uint8_t*) hw)[i] = (uint8_t) value;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Get the index of the lowest voice of the group
+ */
+static uint8_t zvb_sound_first(uint8_t group)
+{
+    uint8_t i = 0;
+    while ((group & BIT(i)) == 0) {
+        i++;
+    }
+    return i;
+}
+
+
+void zvb_sound_commit(void)
+{
+    uint8_t pending;
+
+    if (((s_dirty_freq | s_dirty_wave | s_dirty_vol) & ~s_locked) == 0 && s_dirty_hold == 0) {
+        return;
+    }
+    zvb_sound_map();
+
+    /* Voices that share the same new value are written at once. Both bytes of the divider are
+     * always written, the high byte latches the low one, so the voices don't need to be held.
+     * The locked voices stay dirty, they will be written once unlocked. */
+    pending = s_dirty_freq & ~s_locked;
+    s_dirty_freq &= s_locked;
+    while (pending) {
+        const uint8_t group = zvb_sound_group(&pending, s_freq, s_hw_freq, s_hw_freq_known, sizeof(*s_freq));
+        if (group) {
+            const uint16_t divider = s_freq[zvb_sound_first(group)];
+            zvb_sound_update_shadow(group, s_hw_freq, divider, sizeof(*s_hw_freq));
+            s_hw_freq_known |= group;
+            zvb_sound_select(group);
+            zvb_peri_sound_freq_low  = divider & 0xff;
+            zvb_peri_sound_freq_high = (divider >> 8) & 0xff;
+        }
+    }
+
+    pending = s_dirty_wave & ~s_locked;
+    s_dirty_wave &= s_locked;
+    while (pending) {
+        const uint8_t group = zvb_sound_group(&pending, s_wave, s_hw_wave, s_hw_wave_known, sizeof(*s_wave));
+        if (group) {
+            const uint8_t waveform = s_wave[zvb_sound_first(group)];
+            zvb_sound_update_shadow(group, s_hw_wave, waveform, sizeof(*s_hw_wave));
+            s_hw_wave_known |= group;
+            zvb_sound_select(group);
+            zvb_peri_sound_wave = waveform;
+        }
+    }
+
+    pending = s_dirty_vol & ~s_locked;
+    s_dirty_vol &= s_locked;
+    while (pending) {
+        const uint8_t group = zvb_sound_group(&pending, s_vol, s_hw_vol, s_hw_vol_known, sizeof(*s_vol));
+        if (group) {
+            const uint8_t vol = s_vol[zvb_sound_first(group)];
+            zvb_sound_update_shadow(group, s_hw_vol, vol, sizeof(*s_hw_vol));
+            s_hw_vol_known |= group;
+            zvb_sound_select(group);
+            zvb_peri_sound_volume = vol;
+        }
+    }
+
+    /* Apply the hold last, so that voices start with their new settings */
+    if (s_dirty_hold) {
+        s_dirty_hold = 0;
+        zvb_sound_update_hold();
+    }
+}
+
+
+void zvb_sound_lock(sound_voice_t voices)
+{
+    voices &= SHADOW_VOICES_MASK;
+    /* Newly locked voices are on hold until they are written */
+    s_lock_hold |= voices & ~s_locked;
+    s_locked |= voices;
+}
+
+
+void zvb_sound_unlock(sound_voice_t voices)
+{
+    voices &= SHADOW_VOICES_MASK;
+    s_locked &= ~voices;
+
+    /* Restore the staged values on the next commit */
+    s_hw_freq_known &= ~voices;
+    s_hw_wave_known &= ~voices;
+    s_hw_vol_known &= ~voices;
+    s_dirty_freq |= voices;
+    s_dirty_wave |= voices;
+    s_dirty_vol |= voices;
+    s_dirty_hold = 1;
+}
+
+
+void zvb_sound_write_locked(sound_voice_t voices, uint8_t flags, uint16_t divider, uint8_t waveform, sound_volume_t vol)
+{
+    voices &= s_locked;
+    if (voices == 0) {
+        return;
+    }
+    zvb_sound_map();
+    zvb_sound_select(voices);
+
+    if (flags & SOUND_WRITE_FREQ) {
+        zvb_sound_update_shadow(voices, s_hw_freq, divider, sizeof(*s_hw_freq));
+        s_hw_freq_known |= voices;
+        zvb_peri_sound_freq_low  = divider & 0xff;
+        zvb_peri_sound_freq_high = (divider >> 8) & 0xff;
+    }
+    if (flags & SOUND_WRITE_WAVE) {
+        zvb_sound_update_shadow(voices, s_hw_wave, waveform, sizeof(*s_hw_wave));
+        s_hw_wave_known |= voices;
+        zvb_peri_sound_wave = waveform;
+    }
+    if (flags & SOUND_WRITE_VOL) {
+        zvb_sound_update_shadow(voices, s_hw_vol, vol, sizeof(*s_hw_vol));
+        s_hw_vol_known |= voices;
+        zvb_peri_sound_volume = vol;
+    }
+}
+
+
+void zvb_sound_hold_locked(sound_voice_t voices, uint8_t hold)
+{
+    voices &= s_locked;
+    if (hold == 0) {
+        s_lock_hold &= ~voices;
+    } else {
+        s_lock_hold |= voices;
+    }
+    zvb_sound_map();
+    zvb_sound_update_hold();
+}
+
+
+void zvb_sound_set_voices(sound_voice_t voices, uint16_t divider, sound_waveform_t waveform)
+{
+    zvb_sound_stage_freq(voices, divider);
+    zvb_sound_stage_wave(voices, waveform);
+    zvb_sound_commit();
+}
+
+void zvb_sound_set_voices_vol(sound_voice_t voices, sound_volume_t vol)
+{
+    zvb_sound_stage_vol(voices, vol);
+    zvb_sound_commit();
+}
+
+
+void zvb_sound_set_hold(sound_voice_t voices, uint8_t hold)
+{
+    zvb_sound_stage_hold(voices, hold);
+    zvb_sound_commit();
 }
 
 sound_voice_t zvb_sound_get_hold(void)
@@ -85,23 +402,39 @@ sound_voice_t zvb_sound_get_hold(void)
 
 void zvb_sound_set_channels(sound_voice_t left_voices, sound_voice_t right_voices)
 {
+    const uint8_t known = s_hw_channels_known;
+    if (known && s_hw_left == left_voices && s_hw_right == right_voices) {
+        return;
+    }
     zvb_sound_map();
-    zvb_peri_sound_left_channel = left_voices;
-    zvb_peri_sound_right_channel = right_voices;
+    if (!known || s_hw_left != left_voices) {
+        s_hw_left = left_voices;
+        zvb_peri_sound_left_channel = left_voices;
+    }
+    if (!known || s_hw_right != right_voices) {
+        s_hw_right = right_voices;
+        zvb_peri_sound_right_channel = right_voices;
+    }
+    s_hw_channels_known = 1;
 }
 
 void zvb_sound_set_volume(sound_volume_t vol)
 {
-    zvb_sound_map();
     zvb_sound_set_volumes(vol, vol);
 }
 
 
 void zvb_sound_set_volumes(sound_volume_t left, sound_volume_t right)
 {
-    zvb_sound_map();
     uint8_t val = (left == VOL_0) ? 0x40 : left;
     val |=  (right == VOL_0) ? 0x80 : (right << 2);
+
+    if (s_hw_master_known && s_hw_master == val) {
+        return;
+    }
+    zvb_sound_map();
+    s_hw_master = val;
+    s_hw_master_known = 1;
     zvb_peri_sound_master_vol = val;
 }
 
@@ -118,15 +451,72 @@ static uint8_t zvb_sound_int_to_conf(sample_int mode)
 }
 
 
-static void zvb_sound_wait_empty(void)
+/**
+ * @brief Write a block of bytes to the FIFO with `otir`, without checking the FIFO state.
+ *        The FIFO must have room for all of them.
+ *
+ * @param data Bytes to write (HL)
+ * @param size Number of bytes to write, between 1 and 256, 256 being encoded as 0 (DE)
+ */
+static void zvb_sound_fifo_burst(const uint8_t* data, uint16_t size) __naked __sdcccall(1)
 {
-    while ((zvb_peri_sound_sample_conf & BIT(ZVB_SAMPLE_CONF_READY_BIT)) == 0) {
-    }
+    (void) data;
+    (void) size;
+__asm
+    ; Buffer in HL, size in E (0 means 256)
+    ld b, e
+    ld c, # ZVB_PERI_BASE + 0x0
+    otir
+    ret
+__endasm;
 }
 
-static uint8_t zvb_sound_fifo_full(void)
+
+/**
+ * @brief Write bytes to the FIFO one by one, as long as the FIFO is not full.
+ *
+ * @param data Bytes to write (HL)
+ * @param size Maximum number of bytes to write (DE)
+ *
+ * @return Number of bytes that could NOT be written (DE)
+ */
+static uint16_t zvb_sound_fifo_poll(const uint8_t* data, uint16_t size) __naked __sdcccall(1)
 {
-    return (zvb_peri_sound_sample_conf & BIT(ZVB_SAMPLE_CONF_FULL_BIT)) != 0;
+    (void) data;
+    (void) size;
+__asm
+    ld c, # ZVB_PERI_BASE + 0x0
+zvb_sound_fifo_poll_loop:
+    ld a, d
+    or e
+    ret z
+    ; Stop as soon as the FULL bit is set
+    in a, (ZVB_PERI_BASE + 0x2)
+    and # 1 << ZVB_SAMPLE_CONF_FULL_BIT
+    ret nz
+    outi
+    dec de
+    jp zvb_sound_fifo_poll_loop
+__endasm;
+}
+
+
+uint16_t zvb_sound_fifo_write(const void* samples, uint16_t length)
+{
+    const uint8_t* data = (const uint8_t*) samples;
+    uint16_t written = 0;
+
+    if (length == 0) {
+        return 0;
+    }
+
+    /* When the FIFO is empty, the whole FIFO can be filled at once */
+    if (zvb_peri_sound_sample_conf & BIT(ZVB_SAMPLE_CONF_READY_BIT)) {
+        written = MIN(length, SOUND_SAMPLE_TABLE_SIZE);
+        zvb_sound_fifo_burst(data, written);
+    }
+    /* Fill the remaining free space by checking the FULL bit before each byte */
+    return length - zvb_sound_fifo_poll(data + written, length - written);
 }
 
 
@@ -135,29 +525,180 @@ void zvb_sound_play_samples(sound_samples_conf_t* config, void* samples, uint16_
     if (config == NULL || samples == NULL || length == 0) {
         return;
     }
+
+    zvb_sound_play_samples_async(config, samples, length);
+    while (s_async_status != SOUND_ASYNC_STOPPED) {
+        zvb_sound_service();
+    }
+}
+
+
+void zvb_sound_async_start(sound_samples_conf_t* config, void* ring, uint16_t size)
+{
+    if (config == NULL || ring == NULL || size == 0) {
+        return;
+    }
+    zvb_sound_async_stop();
+
+    s_ring = (uint8_t*) ring;
+    s_ring_size = size;
+    s_ring_rd = 0;
+    s_ring_wr = 0;
+    s_ring_count = 0;
+    s_async_ended = 0;
+
     /* Map the sound controller and enable the sample table voice */
     zvb_sound_map();
-    zvb_peri_sound_select = SAMPTAB;
+    zvb_sound_select(SAMPTAB);
 
     /* Configure the sign and bit-width of each sample, as well as the sample rate divider */
     zvb_peri_sound_sample_conf = zvb_sound_int_to_conf(config->mode);
     zvb_peri_sound_sample_div = config->divider;
 
     /* Unhold sample table if it is held */
-    zvb_peri_sound_hold = s_mst_hold & ~SAMPTAB;
+    s_async_status = SOUND_ASYNC_DRAINING;
+    zvb_sound_update_hold();
+}
 
-    /* Play all the samples */
-    uint8_t* data = (uint8_t*) samples;
 
-    while (length > 0) {
-        if (!zvb_sound_fifo_full()) {
-            zvb_peri_sound_sample_fifo = *data++;
-            length--;
+uint16_t zvb_sound_async_free(void)
+{
+    /* The counter is modified by the service routine, which may run in an interrupt,
+     * make sure both of its bytes are read at once */
+    const uint8_t irq = zvb_irq_save();
+    const uint16_t count = s_ring_count;
+    zvb_irq_restore(irq);
+    return s_ring_size - count;
+}
+
+
+uint8_t* zvb_sound_async_reserve(uint16_t* length)
+{
+    if (s_async_status == SOUND_ASYNC_STOPPED || s_async_ended) {
+        *length = 0;
+        return NULL;
+    }
+    /* Only return the part located before the end of the ring */
+    *length = MIN(zvb_sound_async_free(), s_ring_size - s_ring_wr);
+    return s_ring + s_ring_wr;
+}
+
+
+void zvb_sound_async_commit(uint16_t length)
+{
+    s_ring_wr += length;
+    if (s_ring_wr >= s_ring_size) {
+        s_ring_wr -= s_ring_size;
+    }
+
+    /* The counter is also modified by the service routine, which may run in an interrupt */
+    const uint8_t irq = zvb_irq_save();
+    s_ring_count += length;
+    s_async_status = SOUND_ASYNC_PLAYING;
+    zvb_irq_restore(irq);
+}
+
+
+uint16_t zvb_sound_async_write(const void* samples, uint16_t length)
+{
+    const uint8_t* data = (const uint8_t*) samples;
+    uint16_t total = 0;
+
+    /* Copy the samples in at most two parts, before and after the end of the ring */
+    for (uint8_t i = 0; i < 2 && length != 0; i++) {
+        uint16_t part;
+        uint8_t* dst = zvb_sound_async_reserve(&part);
+        part = MIN(part, length);
+        if (part == 0) {
+            break;
+        }
+        memcpy(dst, data, part);
+        zvb_sound_async_commit(part);
+        data += part;
+        length -= part;
+        total += part;
+    }
+
+    return total;
+}
+
+
+void zvb_sound_async_end(void)
+{
+    s_async_ended = 1;
+}
+
+
+void zvb_sound_play_samples_async(sound_samples_conf_t* config, void* samples, uint16_t length)
+{
+    if (config == NULL || samples == NULL || length == 0) {
+        return;
+    }
+    zvb_sound_async_start(config, samples, length);
+    /* The whole table is already in the "ring". The counter is read by the service routine,
+     * which may run in an interrupt */
+    const uint8_t irq = zvb_irq_save();
+    s_ring_count = length;
+    s_async_ended = 1;
+    s_async_status = SOUND_ASYNC_PLAYING;
+    zvb_irq_restore(irq);
+}
+
+
+void zvb_sound_service(void)
+{
+    if (s_async_status == SOUND_ASYNC_STOPPED) {
+        return;
+    }
+
+    const uint8_t backup = zvb_config_dev_idx;
+    zvb_sound_map();
+    /* The shadow is updated before the register, restoring it is always correct */
+    zvb_peri_sound_select = SAMPTAB;
+
+    /* Write the samples in at most two parts, before and after the end of the ring */
+    while (s_ring_count != 0) {
+        const uint16_t contiguous = MIN(s_ring_count, s_ring_size - s_ring_rd);
+        const uint16_t written = zvb_sound_fifo_write(s_ring + s_ring_rd, contiguous);
+        s_ring_rd += written;
+        if (s_ring_rd == s_ring_size) {
+            s_ring_rd = 0;
+        }
+        s_ring_count -= written;
+        if (written != contiguous) {
+            /* FIFO is full */
+            break;
         }
     }
 
-    /* Make sure all the samples have been played */
-    zvb_sound_wait_empty();
+    if (s_ring_count != 0) {
+        s_async_status = SOUND_ASYNC_PLAYING;
+    } else if (s_async_ended && (zvb_peri_sound_sample_conf & BIT(ZVB_SAMPLE_CONF_READY_BIT))) {
+        /* All the samples have been played */
+        s_async_status = SOUND_ASYNC_STOPPED;
+        zvb_sound_update_hold();
+    } else {
+        s_async_status = SOUND_ASYNC_DRAINING;
+    }
+
+    zvb_peri_sound_select = s_hw_select;
+    zvb_map_peripheral(backup);
+}
 
-    zvb_peri_sound_hold = s_mst_hold;
+
+sound_async_status_t zvb_sound_async_status(void)
+{
+    return s_async_status;
+}
+
+
+void zvb_sound_async_stop(void)
+{
+    if (s_async_status == SOUND_ASYNC_STOPPED) {
+        return;
+    }
+    s_async_status = SOUND_ASYNC_STOPPED;
+    s_ring_count = 0;
+    zvb_sound_map();
+    zvb_sound_update_hold();
 }
@@ -0,0 +1,223 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "zvb_sound_adpcm.h"
+
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+/* Number of ADPCM bytes decoded between two FIFO top ups, 128 samples */
+#define ADPCM_CHUNK_SIZE    64
+
+static const uint16_t s_adpcm_steps[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/* Differences for each step index and each magnitude (lower 3 bits of the nibble),
+ * computed once so that decoding a sample only requires a table lookup */
+static uint16_t s_adpcm_diffs[89 * 8];
+static uint8_t s_adpcm_diffs_ready;
+
+/* Decoder state, the predictor is stored as an unsigned value so that its upper byte
+ * is directly the 8-bit unsigned sample and the saturation only relies on the carry */
+static uint16_t s_adpcm_pred;
+static uint8_t s_adpcm_index;
+static uint8_t s_adpcm_count;
+static const uint8_t* s_adpcm_src;
+static uint16_t s_adpcm_remaining;
+
+
+static void zvb_sound_adpcm_init_diffs(void)
+{
+    uint16_t* diff = s_adpcm_diffs;
+
+    for (uint8_t i = 0; i < 89; i++) {
+        const uint16_t step = s_adpcm_steps[i];
+        for (uint8_t mag = 0; mag < 8; mag++) {
+            uint16_t value = step >> 3;
+            if (mag & 4) value += step;
+            if (mag & 2) value += step >> 1;
+            if (mag & 1) value += step >> 2;
+            *diff++ = value;
+        }
+    }
+    s_adpcm_diffs_ready = 1;
+}
+
+
+/**
+ * @brief Decode `s_adpcm_count` bytes of ADPCM data, two samples per byte.
+ *
+ * @param src ADPCM data to decode (HL)
+ * @param dst Buffer to store the 8-bit unsigned samples in (DE)
+ */
+static void zvb_sound_adpcm_decode(const uint8_t* src, uint8_t* dst) __naked __sdcccall(1)
+{
+    (void) src;
+    (void) dst;
+__asm
+    push ix
+    ld (_s_adpcm_src), hl
+    push de
+    pop ix
+    ld a, (_s_adpcm_count)
+    ld b, a
+zvb_sound_adpcm_decode_byte:
+    ld hl, (_s_adpcm_src)
+    ld c, (hl)
+    inc hl
+    ld (_s_adpcm_src), hl
+    ; Low nibble first
+    call zvb_sound_adpcm_nibble
+    ld a, c
+    rrca
+    rrca
+    rrca
+    rrca
+    ld c, a
+    call zvb_sound_adpcm_nibble
+    djnz zvb_sound_adpcm_decode_byte
+    pop ix
+    ret
+    ; Decode the nibble in the lower 4 bits of C to 0(ix), B is preserved
+zvb_sound_adpcm_nibble:
+    ; DE = s_adpcm_diffs[index * 8 + (nibble & 7)]
+    ld a, (_s_adpcm_index)
+    ld l, a
+    ld h, #0
+    add hl, hl
+    add hl, hl
+    add hl, hl
+    ld a, c
+    and #7
+    or l
+    ld l, a
+    add hl, hl
+    ld de, #_s_adpcm_diffs
+    add hl, de
+    ld e, (hl)
+    inc hl
+    ld d, (hl)
+    ; Add or subtract the difference to the predictor, saturate on carry
+    ld hl, (_s_adpcm_pred)
+    bit 3, c
+    jr nz, zvb_sound_adpcm_nibble_sub
+    add hl, de
+    jr nc, zvb_sound_adpcm_nibble_store
+    ld hl, #0xffff
+    jr zvb_sound_adpcm_nibble_store
+zvb_sound_adpcm_nibble_sub:
+    or a
+    sbc hl, de
+    jr nc, zvb_sound_adpcm_nibble_store
+    ld hl, #0
+zvb_sound_adpcm_nibble_store:
+    ld (_s_adpcm_pred), hl
+    ld 0 (ix), h
+    inc ix
+    ; Adjust the index: -1 when bit 2 is clear, (nibble & 3) * 2 + 2 else, clamped to 0-88
+    ld a, (_s_adpcm_index)
+    bit 2, c
+    jr nz, zvb_sound_adpcm_nibble_inc
+    dec a
+    jp p, zvb_sound_adpcm_nibble_index
+    xor a
+    jr zvb_sound_adpcm_nibble_index
+zvb_sound_adpcm_nibble_inc:
+    ld e, a
+    ld a, c
+    and #3
+    inc a
+    add a, a
+    add a, e
+    cp #89
+    jr c, zvb_sound_adpcm_nibble_index
+    ld a, #88
+zvb_sound_adpcm_nibble_index:
+    ld (_s_adpcm_index), a
+    ret
+__endasm;
+}
+
+
+zos_err_t zvb_sound_adpcm_start(const void* clip, void* ring, uint16_t size)
+{
+    const zvb_adpcm_header_t* header = (const zvb_adpcm_header_t*) clip;
+
+    if (header == NULL || ring == NULL || size < 2 || (size & 1) != 0 ||
+        memcmp(header->magic, "ZAD", 3) != 0 || header->version != ADPCM_VERSION ||
+        header->index > 88)
+    {
+        return ERR_INVALID_PARAMETER;
+    }
+
+    if (!s_adpcm_diffs_ready) {
+        zvb_sound_adpcm_init_diffs();
+    }
+
+    s_adpcm_pred = header->predictor;
+    s_adpcm_index = header->index;
+    s_adpcm_src = (const uint8_t*) clip + ADPCM_HEADER_SIZE;
+    s_adpcm_remaining = header->length;
+
+    sound_samples_conf_t config = {
+        .mode = SAMPLE_UINT8,
+        .divider = header->divider
+    };
+    zvb_sound_async_start(&config, ring, size);
+    zvb_sound_adpcm_service();
+
+    return ERR_SUCCESS;
+}
+
+
+void zvb_sound_adpcm_service(void)
+{
+    while (s_adpcm_remaining != 0) {
+        uint16_t free;
+        uint8_t* dst = zvb_sound_async_reserve(&free);
+        /* Each byte of ADPCM data results in two samples */
+        free = MIN(free / 2, ADPCM_CHUNK_SIZE);
+        if (free == 0) {
+            break;
+        }
+        const uint8_t count = MIN(free, s_adpcm_remaining);
+        s_adpcm_count = count;
+        /* The source pointer is updated by the decoder */
+        zvb_sound_adpcm_decode(s_adpcm_src, dst);
+        s_adpcm_remaining -= count;
+        zvb_sound_async_commit(count * 2);
+        /* Don't let the FIFO starve while decoding */
+        zvb_sound_service();
+    }
+
+    if (s_adpcm_remaining == 0) {
+        zvb_sound_async_end();
+    }
+    zvb_sound_service();
+}
+
+
+zos_err_t zvb_sound_play_adpcm(const void* clip, void* ring, uint16_t size)
+{
+    zos_err_t err = zvb_sound_adpcm_start(clip, ring, size);
+    if (err != ERR_SUCCESS) {
+        return err;
+    }
+    while (zvb_sound_async_status() != SOUND_ASYNC_STOPPED) {
+        zvb_sound_adpcm_service();
+    }
+    return ERR_SUCCESS;
+}
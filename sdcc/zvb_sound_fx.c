@@ -0,0 +1,234 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "zvb_sound_fx.h"
+
+typedef struct {
+    const zvb_fx_instrument_t* instrument;  // NULL when the voice is idle
+    uint16_t base;          // Divider of the note, modified by the slide and the glide
+    uint16_t target;        // Divider to glide to
+    uint16_t glide;         // Glide speed, 0 when not gliding
+    uint8_t vol_pos;
+    uint8_t pitch_pos;
+    uint8_t wave_pos;
+    uint8_t released;
+    uint8_t started;
+} fx_voice_t;
+
+static fx_voice_t s_fx_voices[FX_VOICES];
+
+static const uint8_t s_fx_volumes[] = { VOL_0, VOL_25, VOL_50, VOL_75, VOL_100 };
+
+
+static const uint8_t s_kick_volume[]  = { 4, 4, 3, 3, 2, 2, 1, 1, 0 };
+static const uint8_t s_snare_volume[] = { 4, 3, 3, 2, 2, 1, 1, 0 };
+static const uint8_t s_hihat_volume[] = { 3, 2, 1, 0 };
+
+const zvb_fx_instrument_t zvb_fx_kick = {
+    .volume = { s_kick_volume, sizeof(s_kick_volume), FX_NO_LOOP, FX_NO_SUSTAIN },
+    .waveform = WAV_TRIANGLE,
+    .slide = -24,
+    .divider = SOUND_FREQ_TO_DIV(180),
+};
+
+const zvb_fx_instrument_t zvb_fx_snare = {
+    .volume = { s_snare_volume, sizeof(s_snare_volume), FX_NO_LOOP, FX_NO_SUSTAIN },
+    .waveform = WAV_NOISE,
+    .slide = -200,
+    .divider = SOUND_FREQ_TO_DIV(3000),
+};
+
+const zvb_fx_instrument_t zvb_fx_hihat = {
+    .volume = { s_hihat_volume, sizeof(s_hihat_volume), FX_NO_LOOP, FX_NO_SUSTAIN },
+    .waveform = WAV_NOISE,
+    .divider = SOUND_FREQ_TO_DIV(12000),
+};
+
+
+uint8_t zvb_sound_fx_adsr(zvb_fx_table_t* table, uint8_t* buffer, uint8_t size,
+                          uint8_t attack, uint8_t decay, uint8_t sustain, uint8_t release)
+{
+    const uint16_t length = attack + decay + release + 1;
+    uint8_t i;
+
+    if (table == NULL || buffer == NULL || sustain > FX_VOL_100 || length > size) {
+        return 0;
+    }
+
+    uint8_t* level = buffer;
+    for (i = 1; i <= attack; i++) {
+        *level++ = (i * FX_VOL_100 + attack / 2) / attack;
+    }
+    for (i = 1; i <= decay; i++) {
+        *level++ = FX_VOL_100 - ((FX_VOL_100 - sustain) * i + decay / 2) / decay;
+    }
+    table->sustain = level - buffer;
+    *level++ = sustain;
+    for (i = 1; i <= release; i++) {
+        *level++ = sustain - (sustain * i + release / 2) / release;
+    }
+
+    table->data = buffer;
+    table->length = length;
+    table->loop = FX_NO_LOOP;
+    return length;
+}
+
+
+void zvb_sound_fx_note_on(uint8_t voice, const zvb_fx_instrument_t* instrument, uint16_t divider)
+{
+    if (voice >= FX_VOICES || instrument == NULL) {
+        return;
+    }
+    fx_voice_t* fx = &s_fx_voices[voice];
+    fx->instrument = instrument;
+    fx->base = instrument->divider ? instrument->divider : divider;
+    fx->glide = 0;
+    fx->vol_pos = 0;
+    fx->pitch_pos = 0;
+    fx->wave_pos = 0;
+    fx->released = 0;
+    fx->started = 0;
+}
+
+
+void zvb_sound_fx_stop(uint8_t voice)
+{
+    if (voice >= FX_VOICES || s_fx_voices[voice].instrument == NULL) {
+        return;
+    }
+    s_fx_voices[voice].instrument = NULL;
+    zvb_sound_stage_hold(1 << voice, 1);
+}
+
+
+void zvb_sound_fx_note_off(uint8_t voice)
+{
+    if (voice >= FX_VOICES || s_fx_voices[voice].instrument == NULL) {
+        return;
+    }
+    fx_voice_t* fx = &s_fx_voices[voice];
+    const zvb_fx_table_t* env = &fx->instrument->volume;
+    if (env->sustain == FX_NO_SUSTAIN || env->sustain + 1 >= env->length) {
+        zvb_sound_fx_stop(voice);
+        return;
+    }
+    /* Continue with the release part of the envelope */
+    fx->released = 1;
+    if (fx->vol_pos <= env->sustain) {
+        fx->vol_pos = env->sustain + 1;
+    }
+}
+
+
+void zvb_sound_fx_glide(uint8_t voice, uint16_t divider, uint16_t speed)
+{
+    if (voice >= FX_VOICES) {
+        return;
+    }
+    s_fx_voices[voice].target = divider;
+    s_fx_voices[voice].glide = speed;
+}
+
+
+uint8_t zvb_sound_fx_playing(uint8_t voice)
+{
+    return voice < FX_VOICES && s_fx_voices[voice].instrument != NULL;
+}
+
+
+/**
+ * @brief Get the index following `pos` in the given table
+ */
+static uint8_t zvb_sound_fx_next(const zvb_fx_table_t* table, uint8_t pos)
+{
+    pos++;
+    if (pos < table->length) {
+        return pos;
+    }
+    return (table->loop == FX_NO_LOOP) ? table->length - 1 : table->loop;
+}
+
+
+static void zvb_sound_fx_update(uint8_t index, fx_voice_t* fx)
+{
+    const zvb_fx_instrument_t* inst = fx->instrument;
+    const sound_voice_t mask = 1 << index;
+
+    /* Volume envelope, the note is over once the last value, without loop, is reached */
+    uint8_t level = FX_VOL_100;
+    const zvb_fx_table_t* env = &inst->volume;
+    if (env->length != 0) {
+        level = ((const uint8_t*) env->data)[fx->vol_pos];
+        if (level == FX_VOL_0 && fx->vol_pos == env->length - 1 && env->loop == FX_NO_LOOP) {
+            zvb_sound_fx_stop(index);
+            return;
+        }
+        if (fx->released || fx->vol_pos != env->sustain) {
+            fx->vol_pos = zvb_sound_fx_next(env, fx->vol_pos);
+        }
+        if (level > FX_VOL_100) {
+            level = FX_VOL_100;
+        }
+    }
+
+    /* Pitch offsets on top of the current divider */
+    uint16_t divider = fx->base;
+    const zvb_fx_table_t* pitch = &inst->pitch;
+    if (pitch->length != 0) {
+        divider += ((const int8_t*) pitch->data)[fx->pitch_pos];
+        fx->pitch_pos = zvb_sound_fx_next(pitch, fx->pitch_pos);
+    }
+
+    uint8_t waveform = inst->waveform;
+    const zvb_fx_table_t* wave = &inst->wave;
+    if (wave->length != 0) {
+        waveform = ((const uint8_t*) wave->data)[fx->wave_pos];
+        fx->wave_pos = zvb_sound_fx_next(wave, fx->wave_pos);
+    }
+
+    zvb_sound_stage_freq(mask, divider);
+    zvb_sound_stage_wave(mask, waveform);
+    zvb_sound_stage_vol(mask, s_fx_volumes[level]);
+    if (!fx->started) {
+        fx->started = 1;
+        zvb_sound_stage_hold(mask, 0);
+    }
+
+    /* Prepare the divider of the next tick */
+    if (inst->slide != 0) {
+        const int16_t slide = inst->slide;
+        if (slide < 0 && fx->base < (uint16_t) -slide) {
+            fx->base = 0;
+        } else {
+            fx->base += slide;
+        }
+    }
+    if (fx->glide != 0) {
+        if (fx->base < fx->target) {
+            fx->base = (fx->target - fx->base > fx->glide) ? fx->base + fx->glide : fx->target;
+        } else {
+            fx->base = (fx->base - fx->target > fx->glide) ? fx->base - fx->glide : fx->target;
+        }
+        if (fx->base == fx->target) {
+            fx->glide = 0;
+        }
+    }
+}
+
+
+void zvb_sound_fx_tick(void)
+{
+    fx_voice_t* fx = s_fx_voices;
+    for (uint8_t i = 0; i < FX_VOICES; i++, fx++) {
+        if (fx->instrument != NULL) {
+            zvb_sound_fx_update(i, fx);
+        }
+    }
+    zvb_sound_commit();
+}
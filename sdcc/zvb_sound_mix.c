@@ -0,0 +1,232 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "zvb_sound_mix.h"
+#include "zvb_internal.h"
+
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+typedef struct {
+    const uint8_t* samples;
+    uint16_t remaining;
+    uint8_t shift;
+    uint8_t priority;
+} mix_channel_t;
+
+static mix_channel_t s_mix_channels[MIX_CHANNELS];
+static uint8_t s_mix_channel_count;
+static volatile uint8_t s_mix_active;
+
+/* Parameters of the assembly routines */
+static uint8_t s_mix_count;
+static uint8_t s_mix_shift;
+
+
+/**
+ * @brief Add `s_mix_count` 8-bit unsigned samples, divided by 2^`s_mix_shift`, to the signed
+ *        samples of the destination, with saturation.
+ *
+ * @param src Samples to add (HL)
+ * @param dst Signed samples to add them to (DE)
+ */
+static void zvb_sound_mix_add(const uint8_t* src, int8_t* dst) __naked __sdcccall(1)
+{
+    (void) src;
+    (void) dst;
+__asm
+    push ix
+    ex de, hl
+    ; IX = entry point in the `sra a` sequence below, skip 7 - shift instructions
+    push hl
+    ld a, (_s_mix_shift)
+    add a, a
+    ld c, a
+    ld b, #0
+    ld hl, #zvb_sound_mix_add_shifted
+    or a
+    sbc hl, bc
+    push hl
+    pop ix
+    pop hl
+    ld a, (_s_mix_count)
+    ld b, a
+zvb_sound_mix_add_loop:
+    ; Convert the sample to a signed value
+    ld a, (de)
+    xor #0x80
+    jp (ix)
+    sra a
+    sra a
+    sra a
+    sra a
+    sra a
+    sra a
+    sra a
+zvb_sound_mix_add_shifted:
+    add a, (hl)
+    jp po, zvb_sound_mix_add_store
+    ; Overflow, the sign of the result is inverted
+    ld a, #0x7f
+    jp m, zvb_sound_mix_add_store
+    ld a, #0x80
+zvb_sound_mix_add_store:
+    ld (hl), a
+    inc hl
+    inc de
+    djnz zvb_sound_mix_add_loop
+    pop ix
+    ret
+__endasm;
+}
+
+
+/**
+ * @brief Convert `s_mix_count` signed samples to unsigned samples, in place.
+ *
+ * @param dst Samples to convert (HL)
+ */
+static void zvb_sound_mix_to_unsigned(uint8_t* dst) __naked __sdcccall(1)
+{
+    (void) dst;
+__asm
+    ld a, (_s_mix_count)
+    ld b, a
+    ld c, #0x80
+zvb_sound_mix_to_unsigned_loop:
+    ld a, (hl)
+    xor c
+    ld (hl), a
+    inc hl
+    djnz zvb_sound_mix_to_unsigned_loop
+    ret
+__endasm;
+}
+
+
+void zvb_sound_mix_start(uint8_t channels, uint8_t divider, void* ring, uint16_t size)
+{
+    if (channels == 0 || channels > MIX_CHANNELS) {
+        return;
+    }
+
+    s_mix_active = 0;
+    s_mix_channel_count = channels;
+
+    sound_samples_conf_t config = {
+        .mode = SAMPLE_UINT8,
+        .divider = divider
+    };
+    zvb_sound_async_start(&config, ring, size);
+}
+
+
+uint8_t zvb_sound_mix_play(const zvb_mix_sfx_t* sfx)
+{
+    uint8_t victim = MIX_NO_CHANNEL;
+
+    if (sfx == NULL || sfx->samples == NULL || sfx->length == 0) {
+        return MIX_NO_CHANNEL;
+    }
+
+    for (uint8_t i = 0; i < s_mix_channel_count; i++) {
+        const mix_channel_t* channel = &s_mix_channels[i];
+        if ((s_mix_active & (1 << i)) == 0) {
+            victim = i;
+            break;
+        }
+        /* Steal the lowest priority channel, the closest to its end for equal priorities */
+        if (channel->priority <= sfx->priority &&
+            (victim == MIX_NO_CHANNEL ||
+             channel->priority < s_mix_channels[victim].priority ||
+             (channel->priority == s_mix_channels[victim].priority &&
+              channel->remaining < s_mix_channels[victim].remaining)))
+        {
+            victim = i;
+        }
+    }
+
+    if (victim == MIX_NO_CHANNEL) {
+        return MIX_NO_CHANNEL;
+    }
+
+    /* The channels may be mixed from an interrupt handler */
+    mix_channel_t* channel = &s_mix_channels[victim];
+    const uint8_t irq = zvb_irq_save();
+    channel->samples = sfx->samples;
+    channel->remaining = sfx->length;
+    channel->shift = sfx->shift & 7;
+    channel->priority = sfx->priority;
+    s_mix_active |= 1 << victim;
+    zvb_irq_restore(irq);
+
+    return victim;
+}
+
+
+void zvb_sound_mix_stop(uint8_t channel)
+{
+    if (channel < MIX_CHANNELS) {
+        const uint8_t irq = zvb_irq_save();
+        s_mix_active &= ~(1 << channel);
+        zvb_irq_restore(irq);
+    }
+}
+
+
+uint8_t zvb_sound_mix_active(void)
+{
+    return s_mix_active;
+}
+
+
+void zvb_sound_mix_render(uint8_t* dst, uint16_t count)
+{
+    while (count != 0) {
+        const uint8_t chunk = MIN(count, MIX_CHUNK_SIZE);
+
+        memset(dst, 0, chunk);
+        mix_channel_t* channel = s_mix_channels;
+        for (uint8_t i = 0; i < s_mix_channel_count; i++, channel++) {
+            if ((s_mix_active & (1 << i)) == 0) {
+                continue;
+            }
+            const uint8_t length = MIN(chunk, channel->remaining);
+            s_mix_count = length;
+            s_mix_shift = channel->shift;
+            zvb_sound_mix_add(channel->samples, (int8_t*) dst);
+            channel->samples += length;
+            channel->remaining -= length;
+            if (channel->remaining == 0) {
+                s_mix_active &= ~(1 << i);
+            }
+        }
+        s_mix_count = chunk;
+        zvb_sound_mix_to_unsigned(dst);
+
+        dst += chunk;
+        count -= chunk;
+    }
+}
+
+
+void zvb_sound_mix_service(void)
+{
+    while (s_mix_active != 0) {
+        uint16_t free;
+        uint8_t* dst = zvb_sound_async_reserve(&free);
+        free = MIN(free, MIX_CHUNK_SIZE);
+        if (free == 0) {
+            break;
+        }
+        zvb_sound_mix_render(dst, free);
+        zvb_sound_async_commit(free);
+        /* Don't let the FIFO starve while mixing */
+        zvb_sound_service();
+    }
+    zvb_sound_service();
+}
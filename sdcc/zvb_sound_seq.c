@@ -0,0 +1,201 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "zvb_sound_seq.h"
+
+typedef struct {
+    const uint8_t* events;  // Next event to read, NULL when the pattern is over
+    uint8_t wait;           // Rows remaining before reading the next event
+    uint8_t length;         // Length, in rows, of the notes and rests
+    uint8_t wave;
+    uint16_t divider;
+    const zvb_fx_instrument_t* instrument;
+} seq_voice_t;
+
+static const uint8_t*   s_song;
+static const uint16_t*  s_notes;
+static const uint8_t*   s_orders;
+static const uint16_t*  s_patterns;
+static uint8_t s_playing;
+static uint8_t s_order;
+static uint8_t s_row;
+static uint8_t s_tick;
+static seq_voice_t s_voices[SEQ_VOICES];
+static const zvb_fx_instrument_t* const* s_instruments;
+static uint8_t s_instrument_count;
+
+
+static void zvb_sound_seq_load_order(void)
+{
+    const uint8_t* entry = s_orders + s_order * SEQ_VOICES;
+    seq_voice_t* voice = s_voices;
+
+    for (uint8_t i = 0; i < SEQ_VOICES; i++, voice++) {
+        const uint8_t pattern = entry[i];
+        voice->wait = 0;
+        if (pattern == SEQ_NO_PATTERN) {
+            voice->events = NULL;
+            zvb_sound_fx_stop(i);
+            zvb_sound_stage_hold(1 << i, 1);
+        } else {
+            voice->events = s_song + s_patterns[pattern];
+        }
+    }
+    s_row = 0;
+}
+
+
+/**
+ * @brief Read the events of a voice until one that lasts some rows is found
+ */
+static void zvb_sound_seq_read_events(uint8_t index, seq_voice_t* voice)
+{
+    const sound_voice_t mask = 1 << index;
+    const uint8_t* events = voice->events;
+
+    while (1) {
+        const uint8_t event = *events++;
+        if (event <= SEQ_NOTE_MAX) {
+            voice->divider = s_notes[event];
+            if (voice->instrument != NULL) {
+                zvb_sound_fx_note_on(index, voice->instrument, voice->divider);
+            } else {
+                zvb_sound_stage_freq(mask, voice->divider);
+                zvb_sound_stage_wave(mask, voice->wave);
+                zvb_sound_stage_hold(mask, 0);
+            }
+            break;
+        } else if (event == SEQ_REST) {
+            if (voice->instrument != NULL) {
+                zvb_sound_fx_note_off(index);
+            } else {
+                zvb_sound_stage_hold(mask, 1);
+            }
+            break;
+        } else if (event == SEQ_WAIT) {
+            break;
+        } else if (event == SEQ_LENGTH) {
+            voice->length = *events++;
+        } else if (event == SEQ_WAVE) {
+            voice->wave = *events++;
+        } else if (event == SEQ_VOLUME) {
+            zvb_sound_stage_vol(mask, *events++);
+        } else if (event == SEQ_INSTRUMENT) {
+            const uint8_t instrument = *events++;
+            zvb_sound_fx_stop(index);
+            voice->instrument = (instrument < s_instrument_count) ? s_instruments[instrument] : NULL;
+        } else {
+            /* SEQ_END or unknown event, stop reading this pattern */
+            voice->events = NULL;
+            return;
+        }
+    }
+
+    voice->events = events;
+    voice->wait = voice->length;
+}
+
+
+uint8_t zvb_sound_seq_play(const void* song)
+{
+    const zvb_seq_header_t* header = (const zvb_seq_header_t*) song;
+
+    if (header == NULL || memcmp(header->magic, "ZSQ", 3) != 0 || header->version != SEQ_VERSION ||
+        header->speed == 0 || header->rows == 0 || header->order_len == 0)
+    {
+        return SEQ_INVALID;
+    }
+
+    zvb_sound_seq_stop();
+    s_song = (const uint8_t*) song;
+    s_notes = (const uint16_t*) (s_song + SEQ_HEADER_SIZE);
+    s_orders = (const uint8_t*) (s_notes + header->note_count);
+    s_patterns = (const uint16_t*) (s_orders + header->order_len * SEQ_VOICES);
+
+    for (uint8_t i = 0; i < SEQ_VOICES; i++) {
+        s_voices[i].length = 1;
+        s_voices[i].wave = WAV_SQUARE | DUTY_CYCLE_50_0;
+        s_voices[i].divider = 0;
+        s_voices[i].instrument = NULL;
+    }
+
+    s_order = 0;
+    s_tick = 0;
+    zvb_sound_seq_load_order();
+    zvb_sound_commit();
+    s_playing = 1;
+
+    return SEQ_SUCCESS;
+}
+
+
+void zvb_sound_seq_set_instruments(const zvb_fx_instrument_t* const* instruments, uint8_t count)
+{
+    s_instruments = instruments;
+    s_instrument_count = (instruments == NULL) ? 0 : count;
+}
+
+
+void zvb_sound_seq_stop(void)
+{
+    if (s_playing) {
+        s_playing = 0;
+        for (uint8_t i = 0; i < SEQ_VOICES; i++) {
+            zvb_sound_fx_stop(i);
+        }
+        zvb_sound_set_hold(VOICE0 | VOICE1 | VOICE2 | VOICE3, 1);
+    }
+}
+
+
+uint8_t zvb_sound_seq_playing(void)
+{
+    return s_playing;
+}
+
+
+void zvb_sound_seq_tick(void)
+{
+    if (!s_playing) {
+        return;
+    }
+
+    /* Rows only advance every `speed` ticks */
+    if (s_tick != 0) {
+        s_tick--;
+        return;
+    }
+    const zvb_seq_header_t* header = (const zvb_seq_header_t*) s_song;
+    s_tick = header->speed - 1;
+
+    if (s_row == header->rows) {
+        s_order++;
+        if (s_order == header->order_len) {
+            if (header->loop == SEQ_NO_LOOP || header->loop >= header->order_len) {
+                zvb_sound_seq_stop();
+                return;
+            }
+            s_order = header->loop;
+        }
+        zvb_sound_seq_load_order();
+    }
+
+    seq_voice_t* voice = s_voices;
+    for (uint8_t i = 0; i < SEQ_VOICES; i++, voice++) {
+        if (voice->wait == 0 && voice->events != NULL) {
+            zvb_sound_seq_read_events(i, voice);
+        }
+        if (voice->wait != 0) {
+            voice->wait--;
+        }
+    }
+    s_row++;
+
+    /* Only the registers that changed during this row are written */
+    zvb_sound_commit();
+}
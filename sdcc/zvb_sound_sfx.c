@@ -0,0 +1,203 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "zvb_sound_sfx.h"
+#include "zvb_internal.h"
+
+#define SFX_VOICES_MASK (VOICE0 | VOICE1 | VOICE2 | VOICE3)
+
+typedef struct {
+    const uint8_t* script;  // Next step to play
+    uint8_t wait;           // Ticks left before the next step
+    uint8_t ending;         // The last step is being played
+} sfx_voice_t;
+
+static sfx_voice_t s_sfx_voices[SFX_VOICES];
+
+/* Written by `zvb_sound_sfx_play`, which may run in an interrupt handler, the tick routine
+ * picks the new effects up with the interrupts disabled */
+static const uint8_t* s_sfx_pending[SFX_VOICES];
+static uint8_t s_sfx_priority[SFX_VOICES];
+/* Value of `s_sfx_serial` when the effect of each voice was triggered, to find the oldest one */
+static uint8_t s_sfx_started_at[SFX_VOICES];
+static uint8_t s_sfx_serial;
+static uint8_t s_sfx_start;
+static uint8_t s_sfx_active;
+
+
+static uint8_t zvb_sound_sfx_pick(uint8_t candidates)
+{
+    uint8_t i;
+
+    for (i = 0; i < SFX_VOICES; i++) {
+        if (candidates & (1 << i)) {
+            return i;
+        }
+    }
+    return SFX_NO_VOICE;
+}
+
+
+uint8_t zvb_sound_sfx_play(const uint8_t* script, uint8_t priority, sound_voice_t voices)
+{
+    uint8_t victim;
+    uint8_t i;
+
+    voices &= SFX_VOICES_MASK;
+    if (script == NULL || voices == 0) {
+        return SFX_NO_VOICE;
+    }
+
+    const uint8_t irq = zvb_irq_save();
+    /* Prefer a voice the music doesn't use, then any voice without an effect */
+    victim = zvb_sound_sfx_pick(voices & ~s_sfx_active & zvb_sound_get_hold());
+    if (victim == SFX_NO_VOICE) {
+        victim = zvb_sound_sfx_pick(voices & ~s_sfx_active);
+    }
+    if (victim == SFX_NO_VOICE) {
+        /* Steal the voice with the lowest priority, the oldest effect loses on equal priority.
+         * The age is relative to the current serial, so it survives the counter wrapping around */
+        uint8_t lowest = priority;
+        uint8_t oldest = 0;
+        for (i = 0; i < SFX_VOICES; i++) {
+            const uint8_t age = s_sfx_serial - s_sfx_started_at[i];
+            if ((voices & (1 << i)) == 0 || s_sfx_priority[i] > lowest) {
+                continue;
+            }
+            if (s_sfx_priority[i] < lowest || age >= oldest) {
+                lowest = s_sfx_priority[i];
+                oldest = age;
+                victim = i;
+            }
+        }
+    }
+    if (victim != SFX_NO_VOICE) {
+        s_sfx_pending[victim] = script;
+        s_sfx_priority[victim] = priority;
+        s_sfx_started_at[victim] = s_sfx_serial++;
+        s_sfx_start |= 1 << victim;
+        s_sfx_active |= 1 << victim;
+    }
+    zvb_irq_restore(irq);
+
+    return victim;
+}
+
+
+void zvb_sound_sfx_stop(uint8_t voice)
+{
+    if (voice >= SFX_VOICES || (s_sfx_active & (1 << voice)) == 0) {
+        return;
+    }
+    const uint8_t mask = 1 << voice;
+
+    const uint8_t irq = zvb_irq_save();
+    s_sfx_start &= ~mask;
+    s_sfx_active &= ~mask;
+    zvb_irq_restore(irq);
+
+    s_sfx_voices[voice].script = NULL;
+    zvb_sound_unlock(mask);
+    zvb_sound_commit();
+}
+
+
+void zvb_sound_sfx_stop_all(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < SFX_VOICES; i++) {
+        zvb_sound_sfx_stop(i);
+    }
+}
+
+
+sound_voice_t zvb_sound_sfx_active(void)
+{
+    return s_sfx_active;
+}
+
+
+void zvb_sound_sfx_tick(void)
+{
+    uint8_t start;
+    uint8_t i;
+
+    uint8_t irq = zvb_irq_save();
+    start = s_sfx_start;
+    s_sfx_start = 0;
+    for (i = 0; i < SFX_VOICES; i++) {
+        if (start & (1 << i)) {
+            s_sfx_voices[i].script = s_sfx_pending[i];
+        }
+    }
+    zvb_irq_restore(irq);
+
+    if (start) {
+        zvb_sound_lock(start);
+    }
+
+    for (i = 0; i < SFX_VOICES; i++) {
+        sfx_voice_t* voice = &s_sfx_voices[i];
+        const uint8_t mask = 1 << i;
+
+        if (voice->script == NULL) {
+            continue;
+        }
+        if (start & mask) {
+            voice->wait = 0;
+            voice->ending = 0;
+        }
+
+        if (voice->wait != 0) {
+            voice->wait--;
+            continue;
+        }
+
+        if (voice->ending) {
+            /* The last step is over, give the voice back to the music, unless a new effect
+             * was triggered on it in the meantime */
+            voice->script = NULL;
+            irq = zvb_irq_save();
+            const uint8_t restarted = s_sfx_start & mask;
+            if (!restarted) {
+                s_sfx_active &= ~mask;
+            }
+            zvb_irq_restore(irq);
+            if (!restarted) {
+                zvb_sound_unlock(mask);
+            }
+            continue;
+        }
+
+        const uint8_t* step = voice->script;
+        const uint8_t flags = *step++;
+        uint16_t divider = 0;
+        uint8_t waveform = 0;
+        uint8_t vol = 0;
+        if (flags & SFX_FREQ) {
+            divider = step[0] | (step[1] << 8);
+            step += 2;
+        }
+        if (flags & SFX_WAVE) {
+            waveform = *step++;
+        }
+        if (flags & SFX_VOL) {
+            vol = *step++;
+        }
+        zvb_sound_write_locked(mask, flags, divider, waveform, vol);
+        if (start & mask) {
+            zvb_sound_hold_locked(mask, 0);
+        }
+
+        voice->script = step;
+        voice->wait = (flags >> 3) & 0xf;
+        voice->ending = flags & SFX_END;
+    }
+
+    zvb_sound_commit();
+}
@@ -0,0 +1,171 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <zos_vfs.h>
+#include "zvb_sound_stream.h"
+
+/**
+ * @brief The ring buffer is made out of two chunks: one is being played while the other is being
+ *        read from the file.
+ */
+#define STREAM_CHUNK_SIZE   512
+#define STREAM_RING_SIZE    (2 * STREAM_CHUNK_SIZE)
+
+/**
+ * @brief Sample rate of the sound controller, used to calculate the divider from WAV files
+ */
+#define SOUND_SAMPLE_RATE   44091UL
+
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+static uint8_t s_stream_ring[STREAM_RING_SIZE];
+
+
+static inline uint16_t read_le16(const uint8_t* data)
+{
+    return data[0] | (data[1] << 8);
+}
+
+
+static inline uint32_t read_le32(const uint8_t* data)
+{
+    return read_le16(data) | ((uint32_t) read_le16(data + 2) << 16);
+}
+
+
+/**
+ * @brief Parse the WAV header located at the beginning of the given buffer.
+ *
+ * @param offset Filled with the offset of the first sample in the buffer
+ * @param size Filled with the size of the sample data, in bytes
+ *
+ * @return ERR_SUCCESS if the header is valid and supported, ERR_NO_SUCH_ENTRY if the buffer
+ *         doesn't start with a WAV header, ERR_NOT_SUPPORTED if the format cannot be played
+ */
+static zos_err_t zvb_sound_parse_wav(const uint8_t* buf, uint16_t len, sound_samples_conf_t* conf,
+                                     uint16_t* offset, uint32_t* size)
+{
+    if (len < 12 || memcmp(buf, "RIFF", 4) != 0 || memcmp(buf + 8, "WAVE", 4) != 0) {
+        return ERR_NO_SUCH_ENTRY;
+    }
+
+    uint8_t has_fmt = 0;
+    uint16_t i = 12;
+    /* Browse the chunks until the data one, it must be present in the first bytes of the file */
+    while (i + 8 <= len) {
+        const uint8_t* chunk = buf + i;
+        const uint32_t chunk_size = read_le32(chunk + 4);
+        i += 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && i + 16 <= len) {
+            const uint16_t format = read_le16(chunk + 8);
+            const uint16_t channels = read_le16(chunk + 10);
+            const uint32_t rate = read_le32(chunk + 12);
+            const uint16_t bits = read_le16(chunk + 22);
+            /* Only mono PCM is supported, 8-bit WAV samples are unsigned, 16-bit ones are signed */
+            if (format != 1 || channels != 1 || rate == 0 || rate > SOUND_SAMPLE_RATE) {
+                return ERR_NOT_SUPPORTED;
+            }
+            if (bits == 8) {
+                conf->mode = SAMPLE_UINT8;
+            } else if (bits == 16) {
+                conf->mode = SAMPLE_SINT16;
+            } else {
+                return ERR_NOT_SUPPORTED;
+            }
+            /* The final sample rate is 44091/(divider + 1), round it to the closest one.
+             * The divider is 8-bit, lower rates cannot be played */
+            const uint32_t divider = (SOUND_SAMPLE_RATE + rate / 2) / rate - 1;
+            if (divider > 0xff) {
+                return ERR_NOT_SUPPORTED;
+            }
+            conf->divider = (uint8_t) divider;
+            has_fmt = 1;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!has_fmt) {
+                return ERR_NOT_SUPPORTED;
+            }
+            *offset = i;
+            *size = chunk_size;
+            return ERR_SUCCESS;
+        }
+        /* The chunks located before the data must fit in the buffer, a bigger size comes from a
+         * malformed file. Chunks are aligned on 16-bit */
+        const uint32_t next = (uint32_t) i + chunk_size + (chunk_size & 1);
+        if (chunk_size > (uint32_t) (len - i) || next > len) {
+            return ERR_NOT_SUPPORTED;
+        }
+        i = (uint16_t) next;
+    }
+
+    return ERR_NOT_SUPPORTED;
+}
+
+
+zos_err_t zvb_sound_stream_file(zos_dev_t fd, sound_samples_conf_t* conf)
+{
+    uint16_t size = STREAM_RING_SIZE;
+    uint16_t offset = 0;
+    uint32_t remaining = 0xffffffff;
+    zos_err_t err;
+
+    if (conf == NULL) {
+        return ERR_INVALID_PARAMETER;
+    }
+
+    /* Fill the whole ring first, it may start with a WAV header */
+    err = read(fd, s_stream_ring, &size);
+    if (err != ERR_SUCCESS) {
+        return err;
+    }
+    err = zvb_sound_parse_wav(s_stream_ring, size, conf, &offset, &remaining);
+    if (err == ERR_SUCCESS) {
+        size -= offset;
+        if (size > remaining) {
+            size = (uint16_t) remaining;
+        }
+        memmove(s_stream_ring, s_stream_ring + offset, size);
+    } else if (err != ERR_NO_SUCH_ENTRY) {
+        return err;
+    }
+    remaining -= size;
+
+    zvb_sound_async_start(conf, s_stream_ring, STREAM_RING_SIZE);
+    zvb_sound_async_commit(size);
+    if (size == 0 || remaining == 0) {
+        zvb_sound_async_end();
+    }
+
+    while (zvb_sound_async_status() != SOUND_ASYNC_STOPPED) {
+        zvb_sound_service();
+
+        /* Refill as soon as a whole chunk was played. If the ring end is closer than a chunk,
+         * only fill up to the end so that the next reads are aligned on the chunks again */
+        uint8_t* dst = zvb_sound_async_reserve(&size);
+        if (dst == NULL || size == 0 || zvb_sound_async_free() < STREAM_CHUNK_SIZE) {
+            continue;
+        }
+        size = MIN(size, STREAM_CHUNK_SIZE);
+        if (size > remaining) {
+            size = (uint16_t) remaining;
+        }
+
+        err = read(fd, dst, &size);
+        if (err != ERR_SUCCESS) {
+            zvb_sound_async_stop();
+            return err;
+        }
+        zvb_sound_async_commit(size);
+        remaining -= size;
+        if (size == 0 || remaining == 0) {
+            zvb_sound_async_end();
+        }
+    }
+
+    return ERR_SUCCESS;
+}
@@ -0,0 +1,211 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "zvb_spi.h"
+
+/* Destination of the bytes received by `zvb_spi_transfer` */
+static uint8_t* s_spi_rx;
+
+
+void zvb_spi_initialize(uint8_t clk_div)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_peri_spi_ctrl = BIT(ZVB_PERI_SPI_CTRL_RESET_BIT);
+    zvb_peri_spi_clk_div = clk_div;
+    zvb_peri_spi_ctrl = BIT(ZVB_PERI_SPI_CTRL_CS_STOP_BIT);
+}
+
+
+void zvb_spi_set_clk_div(uint8_t clk_div)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_peri_spi_clk_div = clk_div;
+}
+
+
+uint8_t zvb_spi_get_clk_div(void)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    return zvb_peri_spi_clk_div;
+}
+
+
+void zvb_spi_select(uint8_t cs)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_peri_spi_ctrl = BIT(ZVB_PERI_SPI_CTRL_CS_START_BIT) | ((cs & 1) << ZVB_PERI_SPI_CTRL_CS_BIT);
+}
+
+
+void zvb_spi_deselect(void)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_peri_spi_ctrl = BIT(ZVB_PERI_SPI_CTRL_CS_STOP_BIT);
+}
+
+
+uint8_t zvb_spi_byte(uint8_t value)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_peri_spi_ram_len = 0x80 | 1;
+    zvb_peri_spi_fifo = value;
+    zvb_peri_spi_ctrl = BIT(ZVB_PERI_SPI_CTRL_START_BIT);
+    while ((zvb_peri_spi_ctrl & BIT(ZVB_PERI_SPI_CTRL_IDLE_BIT)) == 0) {
+    }
+    zvb_peri_spi_ram_len = 0x80 | 1;
+    return zvb_peri_spi_fifo;
+}
+
+
+/**
+ * @brief The routines below split the buffers in transactions of up to 8 bytes, the size of the
+ *        controller arrays. Writing the length register with its bit 7 set also resets the FIFO
+ *        indexes, so the arrays are always filled and read with `otir`/`inir` from index 0.
+ */
+static void zvb_spi_send_asm(const uint8_t* tx, uint16_t length) __naked __sdcccall(1)
+{
+    (void) tx;
+    (void) length;
+__asm
+    ; Buffer in HL, length in DE
+    ld a, d
+    or e
+    ret z
+    ld c, # ZVB_PERI_BASE + 0x7
+zvb_spi_send_loop:
+    call zvb_spi_chunk
+    out (ZVB_PERI_BASE + 0x3), a
+    otir
+    call zvb_spi_start
+    ld a, d
+    or e
+    jr nz, zvb_spi_send_loop
+    ret
+
+    ; Get the size of the next transaction in B, min(DE, 8), and subtract it from DE.
+    ; Returns the value to write to the length register in A.
+zvb_spi_chunk:
+    ld b, # ZVB_PERI_SPI_ARRAY_LEN
+    ld a, d
+    or a
+    jr nz, zvb_spi_chunk_full
+    ld a, e
+    cp b
+    jr nc, zvb_spi_chunk_full
+    ld b, e
+zvb_spi_chunk_full:
+    ld a, e
+    sub b
+    ld e, a
+    jr nc, zvb_spi_chunk_no_borrow
+    dec d
+zvb_spi_chunk_no_borrow:
+    ld a, b
+    or #0x80
+    ret
+
+    ; Start the transaction and wait for the controller to be idle again. Alters A only.
+zvb_spi_start:
+    ld a, # 1 << ZVB_PERI_SPI_CTRL_START_BIT
+    out (ZVB_PERI_BASE + 0x1), a
+zvb_spi_start_wait:
+    in a, (ZVB_PERI_BASE + 0x1)
+    rrca
+    jr nc, zvb_spi_start_wait
+    ret
+__endasm;
+}
+
+
+static void zvb_spi_receive_asm(uint8_t* rx, uint16_t length) __naked __sdcccall(1)
+{
+    (void) rx;
+    (void) length;
+__asm
+    ; Buffer in HL, length in DE
+    ld a, d
+    or e
+    ret z
+    ; Fill the output array once, the transactions don't modify it
+    ld a, # 0x80 | ZVB_PERI_SPI_ARRAY_LEN
+    out (ZVB_PERI_BASE + 0x3), a
+    ld a, # SPI_FILL_BYTE
+    ld b, # ZVB_PERI_SPI_ARRAY_LEN
+    ld c, # ZVB_PERI_BASE + 0x7
+zvb_spi_receive_fill:
+    out (c), a
+    djnz zvb_spi_receive_fill
+zvb_spi_receive_loop:
+    call zvb_spi_chunk
+    out (ZVB_PERI_BASE + 0x3), a
+    push af
+    call zvb_spi_start
+    pop af
+    ; Reset the indexes before reading the received bytes
+    out (ZVB_PERI_BASE + 0x3), a
+    inir
+    ld a, d
+    or e
+    jr nz, zvb_spi_receive_loop
+    ret
+__endasm;
+}
+
+
+static void zvb_spi_transfer_asm(const uint8_t* tx, uint16_t length) __naked __sdcccall(1)
+{
+    (void) tx;
+    (void) length;
+__asm
+    ; Buffer to send in HL, length in DE, destination in _s_spi_rx
+    ld a, d
+    or e
+    ret z
+    ld c, # ZVB_PERI_BASE + 0x7
+zvb_spi_transfer_loop:
+    call zvb_spi_chunk
+    out (ZVB_PERI_BASE + 0x3), a
+    otir
+    push af
+    call zvb_spi_start
+    pop af
+    out (ZVB_PERI_BASE + 0x3), a
+    and # 0xf
+    ld b, a
+    push hl
+    ld hl, (_s_spi_rx)
+    inir
+    ld (_s_spi_rx), hl
+    pop hl
+    ld a, d
+    or e
+    jr nz, zvb_spi_transfer_loop
+    ret
+__endasm;
+}
+
+
+void zvb_spi_send(const uint8_t* tx, uint16_t length)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_spi_send_asm(tx, length);
+}
+
+
+void zvb_spi_receive(uint8_t* rx, uint16_t length)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    zvb_spi_receive_asm(rx, length);
+}
+
+
+void zvb_spi_transfer(const uint8_t* tx, uint8_t* rx, uint16_t length)
+{
+    zvb_map_peripheral(ZVB_PERI_SPI_IDX);
+    s_spi_rx = rx;
+    zvb_spi_transfer_asm(tx, length);
+}
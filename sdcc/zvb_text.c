@@ -0,0 +1,153 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "zvb_text.h"
+
+/* Color saved by `zvb_text_save`, the controller only saves the cursor position */
+static uint8_t s_saved_color;
+
+
+/**
+ * @brief Send the characters to the print register, up to 256 per `otir`
+ */
+static void zvb_text_out(const char* buf, uint16_t len) __naked __sdcccall(1)
+{
+    (void) buf;
+    (void) len;
+__asm
+    ; Buffer in HL, length in DE
+    ld c, # ZVB_PERI_BASE + 0x0
+zvb_text_out_loop:
+    ld a, d
+    or a
+    jr z, zvb_text_out_last
+    ; B = 0 sends 256 bytes
+    ld b, # 0
+    otir
+    dec d
+    jr zvb_text_out_loop
+zvb_text_out_last:
+    ld a, e
+    or a
+    ret z
+    ld b, a
+    otir
+    ret
+__endasm;
+}
+
+
+/**
+ * @brief Issue a command to the controller without altering the mode bits of the control register
+ */
+static void zvb_text_command(uint8_t bit)
+{
+    zvb_peri_text_ctrl = (zvb_peri_text_ctrl & TEXT_MODE_MASK) | BIT(bit);
+}
+
+
+void zvb_text_write(const char* buf, uint16_t len)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+
+    while (len) {
+        const char* newline = memchr(buf, '\n', len);
+        const uint16_t part = newline ? (uint16_t) (newline - buf) : len;
+        zvb_text_out(buf, part);
+        if (newline == NULL) {
+            break;
+        }
+        zvb_text_command(ZVB_PERI_TEXT_CTRL_NEXTLINE);
+        buf += part + 1;
+        len -= part + 1;
+    }
+}
+
+
+void zvb_text_print(const char* str)
+{
+    zvb_text_write(str, strlen(str));
+}
+
+
+void zvb_text_put_char(char c)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    if (c == '\n') {
+        zvb_text_command(ZVB_PERI_TEXT_CTRL_NEXTLINE);
+    } else {
+        zvb_peri_text_print_char = c;
+    }
+}
+
+
+void zvb_text_newline(void)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    zvb_text_command(ZVB_PERI_TEXT_CTRL_NEXTLINE);
+}
+
+
+void zvb_text_set_cursor(uint8_t x, uint8_t y)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    zvb_peri_text_curs_x = x;
+    zvb_peri_text_curs_y = y;
+}
+
+
+void zvb_text_get_cursor(uint8_t* x, uint8_t* y)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    *x = zvb_peri_text_curs_x;
+    *y = zvb_peri_text_curs_y;
+}
+
+
+void zvb_text_set_color(uint8_t color)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    zvb_peri_text_color = color;
+}
+
+
+uint8_t zvb_text_get_color(void)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    return zvb_peri_text_color;
+}
+
+
+void zvb_text_set_mode(uint8_t mode)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    zvb_peri_text_ctrl = mode & TEXT_MODE_MASK;
+}
+
+
+uint8_t zvb_text_get_mode(void)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    return zvb_peri_text_ctrl & TEXT_MODE_MASK;
+}
+
+
+void zvb_text_save(void)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    s_saved_color = zvb_peri_text_color;
+    zvb_text_command(ZVB_PERI_TEXT_CTRL_SAVE_CURSOR_BIT);
+}
+
+
+void zvb_text_restore(void)
+{
+    zvb_map_peripheral(ZVB_PERI_TEXT_IDX);
+    zvb_text_command(ZVB_PERI_TEXT_CTRL_RESTORE_CURSOR_BIT);
+    zvb_peri_text_color = s_saved_color;
+}
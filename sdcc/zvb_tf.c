@@ -0,0 +1,491 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "zvb_tf.h"
+#include "zvb_internal.h"
+
+#define MIN(a,b)  ((a) < (b) ? (a) : (b))
+
+/**
+ * @brief Physical memory is mapped in page 0 by `zvb_tf_read_phys`
+ */
+#define TF_VIRT_WINDOW      ZVB_PAGE0_WINDOW
+#define TF_VIRT_PAGE_SIZE   (16*1024)
+
+/* SD commands used in SPI mode */
+#define CMD_GO_IDLE_STATE       0
+#define CMD_SEND_IF_COND        8
+#define CMD_STOP_TRANSMISSION   12
+#define CMD_SET_BLOCKLEN        16
+#define CMD_READ_SINGLE_BLOCK   17
+#define CMD_READ_MULTIPLE_BLOCK 18
+#define CMD_WRITE_BLOCK         24
+#define CMD_WRITE_MULTIPLE      25
+#define CMD_APP_SEND_OP_COND    41
+#define CMD_APP_CMD             55
+#define CMD_READ_OCR            58
+#define CMD_CRC_ON_OFF          59
+
+/* R1 response bits */
+#define R1_IDLE                 0x01
+#define R1_ILLEGAL_COMMAND      0x04
+#define R1_INVALID              0x80
+
+/* Tokens of the data blocks */
+#define TOKEN_START_BLOCK       0xfe
+#define TOKEN_START_MULTIPLE    0xfc
+#define TOKEN_STOP_MULTIPLE     0xfd
+#define DATA_RESPONSE_MASK      0x1f
+#define DATA_RESPONSE_ACCEPTED  0x05
+#define DATA_RESPONSE_CRC_ERROR 0x0b
+
+#define OCR_CCS_BIT             0x40
+#define SEND_IF_COND_ARG        0x1aa
+#define HCS_ARG                 0x40000000UL
+
+/* Number of bytes polled before giving up, ~1 second at full speed */
+#define TF_POLL_TRIES           0xffff
+#define TF_RESET_TRIES          16
+#define TF_INIT_TRIES           0x2000
+#define TF_RESPONSE_TRIES       10
+
+static uint8_t s_tf_type;
+static uint8_t s_tf_crc;
+
+
+static uint8_t zvb_tf_crc7(const uint8_t* data, uint8_t length)
+{
+    uint8_t crc = 0;
+
+    while (length--) {
+        uint8_t byte = *data++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc <<= 1;
+            if ((byte ^ crc) & 0x80) {
+                crc ^= 0x09;
+            }
+            byte <<= 1;
+        }
+    }
+    return crc & 0x7f;
+}
+
+
+/**
+ * @brief CRC16-CCITT (polynomial 0x1021, initial value 0) used by the data blocks
+ */
+static uint16_t zvb_tf_crc16(uint16_t crc, const uint8_t* data, uint16_t length)
+{
+    while (length--) {
+        crc = (crc >> 8) | (crc << 8);
+        crc ^= *data++;
+        crc ^= (crc & 0xff) >> 4;
+        crc ^= crc << 12;
+        crc ^= (crc & 0xff) << 5;
+    }
+    return crc;
+}
+
+
+/**
+ * @brief Wait until the card doesn't hold the line low anymore
+ */
+static uint8_t zvb_tf_wait_ready(void)
+{
+    uint16_t tries = TF_POLL_TRIES;
+
+    while (tries--) {
+        if (zvb_spi_byte(SPI_FILL_BYTE) == 0xff) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Release the chip select, the card needs an extra byte to release the MISO line
+ */
+static void zvb_tf_release(void)
+{
+    zvb_spi_deselect();
+    zvb_spi_byte(SPI_FILL_BYTE);
+}
+
+
+/**
+ * @brief Send a command to the selected card and get its R1 response.
+ *
+ * @return R1 response, R1_INVALID bit set if the card didn't respond
+ */
+static uint8_t zvb_tf_command(uint8_t cmd, uint32_t arg)
+{
+    uint8_t frame[6];
+
+    /* The card is busy streaming data when the transmission is stopped */
+    if (cmd != CMD_GO_IDLE_STATE && cmd != CMD_STOP_TRANSMISSION && !zvb_tf_wait_ready()) {
+        return R1_INVALID;
+    }
+
+    frame[0] = 0x40 | cmd;
+    frame[1] = arg >> 24;
+    frame[2] = arg >> 16;
+    frame[3] = arg >> 8;
+    frame[4] = arg;
+    frame[5] = (zvb_tf_crc7(frame, 5) << 1) | 1;
+    zvb_spi_send(frame, sizeof(frame));
+
+    if (cmd == CMD_STOP_TRANSMISSION) {
+        /* Stuff byte */
+        zvb_spi_byte(SPI_FILL_BYTE);
+    }
+
+    for (uint8_t i = 0; i < TF_RESPONSE_TRIES; i++) {
+        const uint8_t r1 = zvb_spi_byte(SPI_FILL_BYTE);
+        if ((r1 & R1_INVALID) == 0) {
+            return r1;
+        }
+    }
+    return R1_INVALID;
+}
+
+
+static uint8_t zvb_tf_app_command(uint8_t cmd, uint32_t arg)
+{
+    const uint8_t r1 = zvb_tf_command(CMD_APP_CMD, 0);
+    if (r1 & ~R1_IDLE) {
+        return r1;
+    }
+    return zvb_tf_command(cmd, arg);
+}
+
+
+tf_error zvb_tf_init(void)
+{
+    uint8_t response[10];
+    uint8_t r1 = R1_INVALID;
+    uint16_t tries;
+
+    s_tf_type = TF_TYPE_NONE;
+    s_tf_crc = 0;
+    zvb_spi_initialize(SPI_CLK_DIV_SLOW);
+
+    /* At least 74 clock cycles with the chip select high to enter the native mode */
+    zvb_spi_receive(response, sizeof(response));
+
+    zvb_spi_select(SPI_CS_TF);
+    for (tries = 0; tries < TF_RESET_TRIES && r1 != R1_IDLE; tries++) {
+        r1 = zvb_tf_command(CMD_GO_IDLE_STATE, 0);
+    }
+    if (r1 != R1_IDLE) {
+        zvb_tf_release();
+        return TF_NO_CARD;
+    }
+
+    /* Version 2 cards echo the check pattern, version 1 cards don't know the command */
+    uint8_t type = TF_TYPE_SDV1;
+    r1 = zvb_tf_command(CMD_SEND_IF_COND, SEND_IF_COND_ARG);
+    if (r1 == R1_IDLE) {
+        zvb_spi_receive(response, 4);
+        if ((response[2] & 0xf) != (SEND_IF_COND_ARG >> 8) || response[3] != (SEND_IF_COND_ARG & 0xff)) {
+            zvb_tf_release();
+            return TF_NOT_SUPPORTED;
+        }
+        type = TF_TYPE_SDV2;
+    } else if ((r1 & R1_ILLEGAL_COMMAND) == 0) {
+        zvb_tf_release();
+        return TF_NOT_SUPPORTED;
+    }
+
+    /* Wait for the card to leave the idle state */
+    for (tries = 0; tries < TF_INIT_TRIES; tries++) {
+        r1 = zvb_tf_app_command(CMD_APP_SEND_OP_COND, type == TF_TYPE_SDV2 ? HCS_ARG : 0);
+        if (r1 != R1_IDLE) {
+            break;
+        }
+    }
+    if (r1 != 0) {
+        zvb_tf_release();
+        return r1 == R1_IDLE ? TF_TIMEOUT : TF_NOT_SUPPORTED;
+    }
+
+    /* High capacity cards are addressed in blocks instead of bytes */
+    if (type == TF_TYPE_SDV2) {
+        if (zvb_tf_command(CMD_READ_OCR, 0) != 0) {
+            zvb_tf_release();
+            return TF_NOT_SUPPORTED;
+        }
+        zvb_spi_receive(response, 4);
+        if (response[0] & OCR_CCS_BIT) {
+            type = TF_TYPE_SDHC;
+        }
+    }
+    if (type != TF_TYPE_SDHC && zvb_tf_command(CMD_SET_BLOCKLEN, TF_BLOCK_SIZE) != 0) {
+        zvb_tf_release();
+        return TF_NOT_SUPPORTED;
+    }
+
+    zvb_tf_release();
+    zvb_spi_set_clk_div(SPI_CLK_DIV_FAST);
+    s_tf_type = type;
+    return TF_SUCCESS;
+}
+
+
+uint8_t zvb_tf_type(void)
+{
+    return s_tf_type;
+}
+
+
+tf_error zvb_tf_set_crc(uint8_t enable)
+{
+    if (s_tf_type == TF_TYPE_NONE) {
+        return TF_NO_CARD;
+    }
+
+    zvb_spi_select(SPI_CS_TF);
+    const uint8_t r1 = zvb_tf_command(CMD_CRC_ON_OFF, enable ? 1 : 0);
+    zvb_tf_release();
+    if (r1 != 0) {
+        return TF_NOT_SUPPORTED;
+    }
+    s_tf_crc = enable;
+    return TF_SUCCESS;
+}
+
+
+static inline uint32_t zvb_tf_address(uint32_t block)
+{
+    return s_tf_type == TF_TYPE_SDHC ? block : block << 9;
+}
+
+
+/**
+ * @brief Receive bytes into physical memory, mapped in page 0 with the interrupts disabled
+ *
+ * @return CRC16 of the bytes if the CRC check is enabled, 0 else
+ */
+static uint16_t zvb_tf_receive_phys(uint32_t phys, uint16_t length)
+{
+    const uint8_t backup = mmu_page0_ro;
+    uint16_t crc = 0;
+
+    while (length) {
+        const uint16_t offset = (uint16_t) phys & (TF_VIRT_PAGE_SIZE - 1);
+        const uint16_t part = MIN(length, TF_VIRT_PAGE_SIZE - offset);
+        const uint8_t irq = zvb_mmu_map(phys);
+        uint8_t* window = TF_VIRT_WINDOW + offset;
+        zvb_spi_receive(window, part);
+        if (s_tf_crc) {
+            crc = zvb_tf_crc16(crc, window, part);
+        }
+        zvb_mmu_demap(backup, irq);
+
+        phys += part;
+        length -= part;
+    }
+
+    return crc;
+}
+
+
+/**
+ * @brief Receive a data block, either in the buffer or in physical memory if the buffer is NULL
+ */
+static tf_error zvb_tf_receive_block(uint8_t* buffer, uint32_t phys)
+{
+    uint16_t tries = TF_POLL_TRIES;
+    uint8_t token;
+    uint8_t crc[2];
+    uint16_t expected = 0;
+
+    do {
+        token = zvb_spi_byte(SPI_FILL_BYTE);
+    } while (token == 0xff && --tries);
+
+    if (token != TOKEN_START_BLOCK) {
+        return token == 0xff ? TF_TIMEOUT : TF_READ_ERROR;
+    }
+
+    if (buffer != NULL) {
+        zvb_spi_receive(buffer, TF_BLOCK_SIZE);
+        if (s_tf_crc) {
+            expected = zvb_tf_crc16(0, buffer, TF_BLOCK_SIZE);
+        }
+    } else {
+        expected = zvb_tf_receive_phys(phys, TF_BLOCK_SIZE);
+    }
+    zvb_spi_receive(crc, sizeof(crc));
+
+    if (s_tf_crc && ((crc[0] << 8) | crc[1]) != expected) {
+        return TF_CRC_ERROR;
+    }
+    return TF_SUCCESS;
+}
+
+
+static tf_error zvb_tf_read_blocks(uint32_t block, uint8_t* buffer, uint32_t phys, uint16_t count)
+{
+    if (count == 0) {
+        return TF_INVALID_ARG;
+    }
+    if (s_tf_type == TF_TYPE_NONE) {
+        return TF_NO_CARD;
+    }
+
+    const uint8_t multiple = count > 1;
+    tf_error err = TF_SUCCESS;
+
+    zvb_spi_select(SPI_CS_TF);
+    if (zvb_tf_command(multiple ? CMD_READ_MULTIPLE_BLOCK : CMD_READ_SINGLE_BLOCK, zvb_tf_address(block)) != 0) {
+        err = TF_READ_ERROR;
+    }
+
+    while (err == TF_SUCCESS && count--) {
+        err = zvb_tf_receive_block(buffer, phys);
+        if (buffer != NULL) {
+            buffer += TF_BLOCK_SIZE;
+        } else {
+            phys += TF_BLOCK_SIZE;
+        }
+    }
+
+    if (multiple) {
+        zvb_tf_command(CMD_STOP_TRANSMISSION, 0);
+        if (!zvb_tf_wait_ready() && err == TF_SUCCESS) {
+            err = TF_TIMEOUT;
+        }
+    }
+    zvb_tf_release();
+    return err;
+}
+
+
+tf_error zvb_tf_read(uint32_t block, uint8_t* buffer, uint16_t count)
+{
+    if (buffer == NULL) {
+        return TF_INVALID_ARG;
+    }
+    return zvb_tf_read_blocks(block, buffer, 0, count);
+}
+
+
+tf_error zvb_tf_read_phys(uint32_t block, uint32_t phys, uint16_t count)
+{
+    return zvb_tf_read_blocks(block, NULL, phys, count);
+}
+
+
+/**
+ * @brief Dividers tried by the clock negotiation, from the slowest to the fastest: 1MHz, 2.1MHz,
+ *        3.1MHz, 4.2MHz, 5MHz, 6.25MHz, 8.3MHz, 12.5MHz and 25MHz. Cards unreliable at 5MHz still get a
+ *        faster clock than SPI_CLK_DIV_SLOW.
+ */
+static const uint8_t s_tf_clock_divs[] = { 25, 12, 8, 6, 5, 4, 3, 2, SPI_CLK_DIV_MIN };
+
+
+/**
+ * @brief Read the block several times at the current clock, check that all the reads succeed and
+ *        that the content always has the given CRC
+ */
+static uint8_t zvb_tf_check_reads(uint32_t block, uint8_t* buffer, uint16_t reference)
+{
+    for (uint8_t i = 0; i < TF_CLOCK_TEST_READS; i++) {
+        if (zvb_tf_read(block, buffer, 1) != TF_SUCCESS ||
+            zvb_tf_crc16(0, buffer, TF_BLOCK_SIZE) != reference)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+tf_error zvb_tf_negotiate_clock(uint32_t block, uint8_t* buffer, uint8_t* clk_div)
+{
+    if (buffer == NULL || clk_div == NULL) {
+        return TF_INVALID_ARG;
+    }
+
+    /* Reference content, read at the same speed as the initialization */
+    const uint8_t crc_enabled = s_tf_crc;
+    uint8_t best = SPI_CLK_DIV_SLOW;
+    zvb_spi_set_clk_div(best);
+    tf_error err = zvb_tf_set_crc(1);
+    if (err == TF_SUCCESS) {
+        err = zvb_tf_read(block, buffer, 1);
+    }
+    if (err == TF_SUCCESS) {
+        const uint16_t reference = zvb_tf_crc16(0, buffer, TF_BLOCK_SIZE);
+        for (uint8_t i = 0; i < sizeof(s_tf_clock_divs); i++) {
+            const uint8_t div = s_tf_clock_divs[i];
+            zvb_spi_set_clk_div(div);
+            if (!zvb_tf_check_reads(block, buffer, reference)) {
+                break;
+            }
+            best = div;
+        }
+    }
+
+    zvb_spi_set_clk_div(best);
+    *clk_div = best;
+    const tf_error crc_err = zvb_tf_set_crc(crc_enabled);
+    return err != TF_SUCCESS ? err : crc_err;
+}
+
+
+tf_error zvb_tf_write(uint32_t block, const uint8_t* buffer, uint16_t count)
+{
+    if (buffer == NULL || count == 0) {
+        return TF_INVALID_ARG;
+    }
+    if (s_tf_type == TF_TYPE_NONE) {
+        return TF_NO_CARD;
+    }
+
+    const uint8_t multiple = count > 1;
+    tf_error err = TF_SUCCESS;
+    uint8_t crc[2] = { 0xff, 0xff };
+
+    zvb_spi_select(SPI_CS_TF);
+    const uint8_t started = zvb_tf_command(multiple ? CMD_WRITE_MULTIPLE : CMD_WRITE_BLOCK, zvb_tf_address(block)) == 0;
+    if (!started) {
+        err = TF_WRITE_ERROR;
+    }
+
+    while (err == TF_SUCCESS && count--) {
+        zvb_spi_byte(SPI_FILL_BYTE);
+        zvb_spi_byte(multiple ? TOKEN_START_MULTIPLE : TOKEN_START_BLOCK);
+        zvb_spi_send(buffer, TF_BLOCK_SIZE);
+        if (s_tf_crc) {
+            const uint16_t value = zvb_tf_crc16(0, buffer, TF_BLOCK_SIZE);
+            crc[0] = value >> 8;
+            crc[1] = value & 0xff;
+        }
+        zvb_spi_send(crc, sizeof(crc));
+
+        const uint8_t response = zvb_spi_byte(SPI_FILL_BYTE) & DATA_RESPONSE_MASK;
+        if (response != DATA_RESPONSE_ACCEPTED) {
+            err = response == DATA_RESPONSE_CRC_ERROR ? TF_CRC_ERROR : TF_WRITE_ERROR;
+        } else if (!zvb_tf_wait_ready()) {
+            err = TF_TIMEOUT;
+        }
+        buffer += TF_BLOCK_SIZE;
+    }
+
+    /* The stop token must be sent even after an error, the card expects more blocks */
+    if (multiple && started) {
+        zvb_spi_byte(TOKEN_STOP_MULTIPLE);
+        zvb_spi_byte(SPI_FILL_BYTE);
+        if (!zvb_tf_wait_ready() && err == TF_SUCCESS) {
+            err = TF_TIMEOUT;
+        }
+    }
+    zvb_tf_release();
+    return err;
+}
@@ -0,0 +1,102 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include "zvb_gfx.h"
+#include "zvb_crc.h"
+#include "zvb_tile_cache.h"
+
+/* The tileset is 64KB big, regardless of the video mode */
+#define TILESET_SIZE    (64UL*1024)
+
+
+gfx_error gfx_tile_cache_init(gfx_context* ctx, gfx_tile_cache* cache, gfx_tile_cache_entry* entries,
+                              uint16_t first, uint16_t count)
+{
+    if (ctx == NULL || cache == NULL || entries == NULL || count == 0) {
+        return GFX_INVALID_ARG;
+    }
+
+    const uint16_t tile_size = ctx->bpp == 8 ? 256 : 128;
+    if (((uint32_t) first + count) * tile_size > TILESET_SIZE) {
+        return GFX_INVALID_ARG;
+    }
+
+    cache->entries = entries;
+    cache->first = first;
+    cache->count = count;
+    cache->tile_size = tile_size;
+    gfx_tile_cache_reset(cache);
+    return GFX_SUCCESS;
+}
+
+
+void gfx_tile_cache_reset(gfx_tile_cache* cache)
+{
+    cache->used = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+    memset(cache->buckets, 0xff, sizeof(cache->buckets));
+}
+
+
+uint16_t gfx_tile_cache_load(gfx_context* ctx, gfx_tile_cache* cache, void* tile)
+{
+    if (ctx == NULL || cache == NULL || tile == NULL) {
+        return TILE_CACHE_NO_SLOT;
+    }
+
+    zvb_crc_initialize(1);
+    const uint32_t crc = zvb_crc_update(tile, cache->tile_size);
+    uint16_t* bucket = &cache->buckets[(uint8_t) crc & (TILE_CACHE_BUCKETS - 1)];
+
+    for (uint16_t slot = *bucket; slot != TILE_CACHE_NO_SLOT; slot = cache->entries[slot].next) {
+        if (cache->entries[slot].crc == crc) {
+            cache->hits++;
+            return cache->first + slot;
+        }
+    }
+
+    if (cache->used == cache->count) {
+        return TILE_CACHE_NO_SLOT;
+    }
+
+    const uint16_t slot = cache->used;
+    const gfx_tileset_options options = {
+        .compression = TILESET_COMP_NONE,
+        .from_byte = (cache->first + slot) * cache->tile_size,
+    };
+    if (gfx_tileset_load(ctx, tile, cache->tile_size, &options) != GFX_SUCCESS) {
+        return TILE_CACHE_NO_SLOT;
+    }
+
+    /* New entries are inserted at the head of the buckets, so the most recent slots are always
+     * first, which makes releasing them cheap */
+    cache->entries[slot].crc = crc;
+    cache->entries[slot].next = *bucket;
+    *bucket = slot;
+    cache->used++;
+    cache->misses++;
+    return cache->first + slot;
+}
+
+
+uint16_t gfx_tile_cache_mark(const gfx_tile_cache* cache)
+{
+    return cache->used;
+}
+
+
+void gfx_tile_cache_release(gfx_tile_cache* cache, uint16_t mark)
+{
+    while (cache->used > mark) {
+        const uint16_t slot = --cache->used;
+        uint16_t* bucket = &cache->buckets[(uint8_t) cache->entries[slot].crc & (TILE_CACHE_BUCKETS - 1)];
+        /* The slots are released from the most recent one, it is the head of its bucket */
+        *bucket = cache->entries[slot].next;
+    }
+}
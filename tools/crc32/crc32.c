@@ -0,0 +1,236 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "crc32.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CRC32_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/* Reflected polynomial 0x04C11DB7 */
+#define CRC32_POLY_REFLECTED    0xEDB88320u
+
+/* The PCLMUL implementation folds 64 bytes at once, smaller buffers go through slice-by-8 */
+#define CRC32_PCLMUL_MIN_LEN    64
+
+static uint32_t s_tables[8][256];
+static int s_tables_ready;
+
+
+static void crc32_init_tables(void)
+{
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ (CRC32_POLY_REFLECTED & -(crc & 1));
+        }
+        s_tables[0][i] = crc;
+    }
+    /* Table n gives the CRC of a byte followed by n zero bytes */
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            const uint32_t prev = s_tables[t - 1][i];
+            s_tables[t][i] = (prev >> 8) ^ s_tables[0][prev & 0xff];
+        }
+    }
+    s_tables_ready = 1;
+}
+
+
+static inline uint32_t read_le32(const uint8_t* data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t) data[3] << 24);
+}
+
+
+uint32_t crc32_update_bitwise(uint32_t state, const void* data, size_t len)
+{
+    const uint8_t* bytes = data;
+
+    while (len--) {
+        state ^= *bytes++;
+        for (int j = 0; j < 8; j++) {
+            state = (state >> 1) ^ (CRC32_POLY_REFLECTED & -(state & 1));
+        }
+    }
+    return state;
+}
+
+
+uint32_t crc32_update_slice8(uint32_t state, const void* data, size_t len)
+{
+    const uint8_t* bytes = data;
+
+    if (!s_tables_ready) {
+        crc32_init_tables();
+    }
+
+    while (len >= 8) {
+        const uint32_t low  = read_le32(bytes) ^ state;
+        const uint32_t high = read_le32(bytes + 4);
+        state = s_tables[7][low & 0xff] ^
+                s_tables[6][(low >> 8) & 0xff] ^
+                s_tables[5][(low >> 16) & 0xff] ^
+                s_tables[4][low >> 24] ^
+                s_tables[3][high & 0xff] ^
+                s_tables[2][(high >> 8) & 0xff] ^
+                s_tables[1][(high >> 16) & 0xff] ^
+                s_tables[0][high >> 24];
+        bytes += 8;
+        len -= 8;
+    }
+    while (len--) {
+        state = (state >> 8) ^ s_tables[0][(state ^ *bytes++) & 0xff];
+    }
+    return state;
+}
+
+
+#ifdef CRC32_X86
+
+int crc32_has_pclmul(void)
+{
+    static int s_checked = -1;
+    unsigned int eax, ebx, ecx, edx;
+
+    if (s_checked < 0) {
+        s_checked = __get_cpuid(1, &eax, &ebx, &ecx, &edx) &&
+                    (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSE4_1) != 0;
+    }
+    return s_checked;
+}
+
+
+/**
+ * @brief Fold the buffer with carry-less multiplications, as described in Intel's "Fast CRC
+ *        Computation for Generic Polynomials Using PCLMULQDQ Instruction", with the constants
+ *        of the reflected domain.
+ *
+ * @param len Length of the buffer, at least 64 and a multiple of 16
+ */
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc32_fold_pclmul(uint32_t state, const uint8_t* buf, size_t len)
+{
+    static const uint64_t __attribute__((aligned(16))) k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    static const uint64_t __attribute__((aligned(16))) k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    static const uint64_t __attribute__((aligned(16))) k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    static const uint64_t __attribute__((aligned(16))) poly[] = { 0x01db710641, 0x01f7011641 };
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i*) (buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i*) (buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i*) (buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i*) (buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(state));
+    x0 = _mm_load_si128((const __m128i*) k1k2);
+    buf += 64;
+    len -= 64;
+
+    /* Fold 4 blocks of 16 bytes in parallel */
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*) (buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*) (buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*) (buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*) (buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    /* Fold the 4 blocks into a single one */
+    x0 = _mm_load_si128((const __m128i*) k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* Fold the remaining blocks of 16 bytes */
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*) buf)), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    /* Fold 128 bits to 64 bits */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i*) k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x0 = _mm_load_si128((const __m128i*) poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t) _mm_extract_epi32(x1, 1);
+}
+
+
+uint32_t crc32_update_pclmul(uint32_t state, const void* data, size_t len)
+{
+    const uint8_t* bytes = data;
+
+    if (len >= CRC32_PCLMUL_MIN_LEN && crc32_has_pclmul()) {
+        const size_t folded = len & ~(size_t) 15;
+        state = crc32_fold_pclmul(state, bytes, folded);
+        bytes += folded;
+        len -= folded;
+    }
+    return crc32_update_slice8(state, bytes, len);
+}
+
+#else
+
+int crc32_has_pclmul(void)
+{
+    return 0;
+}
+
+
+uint32_t crc32_update_pclmul(uint32_t state, const void* data, size_t len)
+{
+    return crc32_update_slice8(state, data, len);
+}
+
+#endif // CRC32_X86
+
+
+uint32_t crc32_update(uint32_t state, const void* data, size_t len)
+{
+    return crc32_update_pclmul(state, data, len);
+}
+
+
+uint32_t crc32_buffer(const void* data, size_t len)
+{
+    return crc32_final(crc32_update(CRC32_INIT, data, len));
+}
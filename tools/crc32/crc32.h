@@ -0,0 +1,71 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Host implementation of the CRC32 calculated by the Zeal 8-bit VideoBoard CRC peripheral
+ *        (`zvb_crc.h`): polynomial 0x04C11DB7, reflected input and output, initial value and
+ *        final XOR 0xFFFFFFFF. This is the same CRC32 as zlib, PNG or Ethernet.
+ *
+ *        The state passed between the update calls is the raw CRC register, start with
+ *        CRC32_INIT and apply `crc32_final` once all the data has been fed.
+ */
+
+#define CRC32_INIT      0xFFFFFFFFu
+#define CRC32_CHECK     0xCBF43926u     // CRC32 of the ASCII string "123456789"
+
+
+typedef uint32_t (*crc32_update_fn)(uint32_t state, const void* data, size_t len);
+
+
+/**
+ * @brief Calculate the CRC32 of a buffer at once, with the fastest implementation available.
+ */
+uint32_t crc32_buffer(const void* data, size_t len);
+
+
+/**
+ * @brief Feed a buffer to the CRC calculation, with the fastest implementation available.
+ */
+uint32_t crc32_update(uint32_t state, const void* data, size_t len);
+
+
+/**
+ * @brief Get the CRC32 out of the state.
+ */
+static inline uint32_t crc32_final(uint32_t state)
+{
+    return state ^ 0xFFFFFFFFu;
+}
+
+
+/**
+ * @brief Reference implementation, one bit at a time, used to check the other ones.
+ */
+uint32_t crc32_update_bitwise(uint32_t state, const void* data, size_t len);
+
+
+/**
+ * @brief Table-driven implementation processing 8 bytes per iteration (slice-by-8).
+ */
+uint32_t crc32_update_slice8(uint32_t state, const void* data, size_t len);
+
+
+/**
+ * @brief Carry-less multiplication folding implementation, only available on x86 CPUs
+ *        supporting PCLMULQDQ and SSE4.1. Falls back to slice-by-8 on others.
+ */
+uint32_t crc32_update_pclmul(uint32_t state, const void* data, size_t len);
+
+
+/**
+ * @brief Check whether `crc32_update_pclmul` is hardware accelerated on this CPU.
+ */
+int crc32_has_pclmul(void);
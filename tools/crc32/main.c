@@ -0,0 +1,213 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "crc32.h"
+
+#define READ_BUFFER_SIZE    (1024 * 1024)
+#define BENCH_DEFAULT_MB    256
+
+typedef struct {
+    const char* name;
+    crc32_update_fn update;
+} impl_t;
+
+static const impl_t s_impls[] = {
+    { "bitwise",  crc32_update_bitwise },
+    { "slice-by-8", crc32_update_slice8 },
+    { "pclmul",   crc32_update_pclmul },
+};
+
+#define IMPL_COUNT  (sizeof(s_impls) / sizeof(s_impls[0]))
+
+/**
+ * @brief Expected results, they match the ones returned by `zvb_crc_update` on the hardware.
+ *        The special patterns (0x100 and above) are generated by `fill_pattern`.
+ */
+#define PATTERN_ZEROS   0x100
+#define PATTERN_ONES    0x101
+#define PATTERN_COUNT   0x102
+
+typedef struct {
+    const char* data;
+    int pattern;
+    size_t len;
+    uint32_t crc;
+} vector_t;
+
+static const vector_t s_vectors[] = {
+    { "", 0, 0, 0x00000000 },
+    { "a", 0, 1, 0xE8B7BE43 },
+    { "abc", 0, 3, 0x352441C2 },
+    { "123456789", 0, 9, CRC32_CHECK },
+    { "The quick brown fox jumps over the lazy dog", 0, 43, 0x414FA339 },
+    { NULL, PATTERN_ZEROS, 32, 0x190A55AD },
+    { NULL, PATTERN_ONES, 32, 0xFF6CAB0B },
+    { NULL, PATTERN_COUNT, 32, 0x91267E8A },
+    { NULL, PATTERN_COUNT, 256, 0x29058C73 },
+};
+
+
+static void usage(const char* name)
+{
+    printf("usage: %s [-t] [-b [MB]] [file1] ... [fileN]\n", name);
+    printf("  -t        run the self-test\n");
+    printf("  -b [MB]   benchmark each implementation on MB megabytes (default %d)\n", BENCH_DEFAULT_MB);
+    printf("Without option, print the CRC32 of each file, or of the standard input\n");
+}
+
+
+static void fill_pattern(uint8_t* buffer, int pattern, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buffer[i] = pattern == PATTERN_ZEROS ? 0x00 :
+                    pattern == PATTERN_ONES  ? 0xff :
+                    (uint8_t) i;
+    }
+}
+
+
+static int self_test(void)
+{
+    uint8_t buffer[4096 + 16];
+    int failures = 0;
+
+    /* Known vectors, with every implementation */
+    for (size_t v = 0; v < sizeof(s_vectors) / sizeof(s_vectors[0]); v++) {
+        const vector_t* vector = &s_vectors[v];
+        if (vector->data) {
+            memcpy(buffer, vector->data, vector->len);
+        } else {
+            fill_pattern(buffer, vector->pattern, vector->len);
+        }
+        for (size_t i = 0; i < IMPL_COUNT; i++) {
+            const uint32_t crc = crc32_final(s_impls[i].update(CRC32_INIT, buffer, vector->len));
+            if (crc != vector->crc) {
+                printf("FAIL %s: vector %zu, got %08x, expected %08x\n", s_impls[i].name, v, crc, vector->crc);
+                failures++;
+            }
+        }
+    }
+
+    /* Compare the fast implementations with the reference one, for all the lengths around the
+     * block sizes, misaligned buffers and updates split in two */
+    srand(0x2ea1);
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        buffer[i] = rand();
+    }
+    for (size_t len = 0; len <= 4096; len += (len < 300 ? 1 : 61)) {
+        const size_t offset = len % 16;
+        const size_t split = len / 3;
+        const uint32_t expected = crc32_update_bitwise(CRC32_INIT, buffer + offset, len);
+        for (size_t i = 1; i < IMPL_COUNT; i++) {
+            const uint32_t whole = s_impls[i].update(CRC32_INIT, buffer + offset, len);
+            uint32_t parts = s_impls[i].update(CRC32_INIT, buffer + offset, split);
+            parts = s_impls[i].update(parts, buffer + offset + split, len - split);
+            if (whole != expected || parts != expected) {
+                printf("FAIL %s: length %zu, got %08x/%08x, expected %08x\n",
+                       s_impls[i].name, len, whole, parts, expected);
+                failures++;
+            }
+        }
+    }
+
+    printf("Self-test %s, PCLMULQDQ %s\n", failures ? "failed" : "passed",
+           crc32_has_pclmul() ? "used" : "not available");
+    return failures ? 1 : 0;
+}
+
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static int benchmark(size_t megabytes)
+{
+    const size_t size = megabytes * 1024 * 1024;
+    uint8_t* buffer = malloc(size);
+    if (buffer == NULL) {
+        fprintf(stderr, "error: could not allocate %zu MB\n", megabytes);
+        return 1;
+    }
+    for (size_t i = 0; i < size; i++) {
+        buffer[i] = (uint8_t) (i * 31 + (i >> 8));
+    }
+
+    for (size_t i = 0; i < IMPL_COUNT; i++) {
+        /* The bitwise implementation is too slow to process the whole buffer */
+        const size_t len = i == 0 ? size / 64 : size;
+        const double start = now_seconds();
+        const uint32_t crc = crc32_final(s_impls[i].update(CRC32_INIT, buffer, len));
+        const double elapsed = now_seconds() - start;
+        printf("%-12s %08x  %8.3f GB/s\n", s_impls[i].name, crc, len / elapsed / 1e9);
+    }
+
+    free(buffer);
+    return 0;
+}
+
+
+static int print_file_crc(const char* name)
+{
+    static uint8_t buffer[READ_BUFFER_SIZE];
+    FILE* file = name ? fopen(name, "rb") : stdin;
+    uint32_t state = CRC32_INIT;
+    size_t len;
+
+    if (file == NULL) {
+        fprintf(stderr, "error: could not open %s\n", name);
+        return 1;
+    }
+    while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        state = crc32_update(state, buffer, len);
+    }
+    const int failed = ferror(file);
+    if (name) {
+        fclose(file);
+    }
+    if (failed) {
+        fprintf(stderr, "error: could not read %s\n", name ? name : "standard input");
+        return 1;
+    }
+
+    printf("%08x    %s\n", crc32_final(state), name ? name : "-");
+    return 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    int ret = 0;
+
+    if (argc == 1) {
+        return print_file_crc(NULL);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0) {
+            ret |= self_test();
+        } else if (strcmp(argv[i], "-b") == 0) {
+            size_t megabytes = BENCH_DEFAULT_MB;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                megabytes = strtoul(argv[++i], NULL, 0);
+            }
+            ret |= benchmark(megabytes ? megabytes : BENCH_DEFAULT_MB);
+        } else if (strcmp(argv[i], "-h") == 0) {
+            usage(argv[0]);
+        } else {
+            ret |= print_file_crc(argv[i]);
+        }
+    }
+
+    return ret;
+}
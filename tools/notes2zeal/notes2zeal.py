@@ -0,0 +1,381 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import os
+import struct
+import sys
+from pathlib import Path
+
+# Must be kept in sync with `include/zvb_sound_seq.h`
+SEQ_MAGIC       = b"ZSQ"
+SEQ_VERSION     = 1
+SEQ_VOICES      = 4
+SEQ_NO_LOOP     = 0xff
+SEQ_NO_PATTERN  = 0xff
+SEQ_NOTE_MAX    = 0x7f
+SEQ_REST        = 0x80
+SEQ_WAIT        = 0x81
+SEQ_LENGTH      = 0x82
+SEQ_WAVE        = 0x83
+SEQ_VOLUME      = 0x84
+SEQ_INSTRUMENT  = 0x85
+SEQ_NO_INSTRUMENT = 0xff
+SEQ_END         = 0xff
+
+# Must be kept in sync with `include/zvb_sound.h`
+SOUND_CLOCK     = 44091
+DUTY_CYCLE_50_0 = 0b100 << 5
+VOLUMES         = [ 0x80, 0x00, 0x01, 0x02, 0x03 ]
+
+# The v-blank occurs 60 times per second, one tick per v-blank
+TICKS_PER_SEC   = 60
+
+NOTES = {
+  "DO": (0, True), "RE": (2, True), "MI": (4, False), "FA": (5, True),
+  "SO": (7, True), "SOL": (7, True), "LA": (9, True), "SI": (11, False),
+}
+
+parser = argparse.ArgumentParser("notes2zeal")
+parser.add_argument("-i", "--input", help="Input notes.txt or MIDI (.mid) file", required=True)
+parser.add_argument("-o", "--output", help="Output file, defaults to the input with a .zsq extension")
+parser.add_argument("-s", "--speed", help="Number of ticks (frames) per row", type=int, default=1)
+parser.add_argument("-r", "--rows", help="Number of rows per pattern", type=int, default=64)
+parser.add_argument("-l", "--loop", help="Order entry to loop to at the end of the song", type=int, default=None)
+parser.add_argument("-t", "--track", help="MIDI track to convert, defaults to the first one with notes", type=int, default=None)
+parser.add_argument("-v", "--verbose", help="Verbose output", action='store_true')
+
+
+def error(msg):
+  print(f"error: {msg}", file=sys.stderr)
+  sys.exit(1)
+
+
+def midi_to_divider(note):
+  """Convert a MIDI note number into a divider, same as `SOUND_FREQ_TO_DIV`"""
+  freq = 440.0 * 2 ** ((note - 69) / 12)
+  div = int(65536 * freq / SOUND_CLOCK)
+  if div <= 0 or div > 0xffff:
+    return None
+  return div
+
+
+class Voice:
+  """Timeline of a single voice, each entry is one of:
+     ("note", divider, rows), ("rest", rows), ("wave", value), ("vol", value), ("inst", value)"""
+  def __init__(self):
+    self.events = []
+    self.rows = 0
+
+  def add_note(self, divider, rows):
+    if rows > 0:
+      self.events.append(("note", divider, rows))
+      self.rows += rows
+
+  def add_rest(self, rows):
+    if rows > 0:
+      self.events.append(("rest", rows))
+      self.rows += rows
+
+  def add_setting(self, kind, value):
+    self.events.append((kind, value))
+
+
+def ms_to_rows(ms, speed):
+  return max(1, round(ms * TICKS_PER_SEC / (1000 * speed)))
+
+
+def parse_notes(path, speed):
+  """Parse the `notes.txt` syntax of `examples/sound`, extended with voices and volumes"""
+  voices = [ Voice() for _ in range(SEQ_VOICES) ]
+  current = 0
+  rows = ms_to_rows(400, speed)
+  waves = [ DUTY_CYCLE_50_0 ] * SEQ_VOICES
+
+  with open(path, "r") as f:
+    for lineno, line in enumerate(f, 1):
+      line = line.strip()
+      if not line or line.startswith(";"):
+        continue
+      token = line.split()[0].upper()
+      where = f"{path}:{lineno}"
+
+      if token == "-":
+        voices[current].add_rest(rows)
+      elif token.startswith("="):
+        try:
+          ms = int(token[1:])
+        except ValueError:
+          error(f"{where}: invalid duration {token}")
+        rows = ms_to_rows(ms, speed)
+      elif token.startswith("@"):
+        if token[1:] not in ("0", "1", "2", "3"):
+          error(f"{where}: invalid voice {token}")
+        current = int(token[1:])
+      elif token[0] == "T" and token[1:].isdigit():
+        wave = int(token[1:])
+        if wave > 3:
+          error(f"{where}: invalid waveform {token}")
+        waves[current] = (waves[current] & 0xe0) | wave
+        voices[current].add_setting("wave", waves[current])
+      elif token[0] == "P" and token[1:].isdigit():
+        duty = int(token[1:])
+        if duty < 1 or duty > 7:
+          error(f"{where}: invalid duty cycle {token}")
+        waves[current] = (waves[current] & 0x1f) | (duty << 5)
+        voices[current].add_setting("wave", waves[current])
+      elif token[0] == "V" and token[1:].isdigit():
+        vol = int(token[1:])
+        if vol >= len(VOLUMES):
+          error(f"{where}: invalid volume {token}")
+        voices[current].add_setting("vol", VOLUMES[vol])
+      elif token == "I-":
+        voices[current].add_setting("inst", SEQ_NO_INSTRUMENT)
+      elif token[0] == "I" and token[1:].isdigit():
+        inst = int(token[1:])
+        if inst >= SEQ_NO_INSTRUMENT:
+          error(f"{where}: invalid instrument {token}")
+        voices[current].add_setting("inst", inst)
+      else:
+        name = token.rstrip("#0123456789")
+        rest = token[len(name):]
+        sharp = rest.endswith("#")
+        octave = rest.rstrip("#")
+        if name not in NOTES or not octave.isdigit() or not 1 <= int(octave) <= 5:
+          error(f"{where}: invalid note {token}")
+        index, hassharp = NOTES[name]
+        if sharp:
+          if not hassharp:
+            error(f"{where}: invalid note {token}")
+          index += 1
+        # DO5 is 1047Hz, which is MIDI note 84
+        divider = midi_to_divider(12 * (int(octave) + 2) + index)
+        voices[current].add_note(divider, rows)
+
+  return voices
+
+
+def read_varlen(data, pos):
+  value = 0
+  while True:
+    byte = data[pos]
+    pos += 1
+    value = (value << 7) | (byte & 0x7f)
+    if byte & 0x80 == 0:
+      return value, pos
+
+
+def parse_midi(path, speed, track_index):
+  """Parse a standard MIDI file, only a single track is converted, polyphony is
+     spread over the 4 voices"""
+  data = Path(path).read_bytes()
+  if data[0:4] != b"MThd":
+    error(f"{path}: not a MIDI file")
+  hlen, fmt, ntracks, division = struct.unpack(">IHHH", data[4:14])
+  if division & 0x8000:
+    error(f"{path}: SMPTE time division is not supported")
+  pos = 8 + hlen
+
+  tempos = [ (0, 500000) ]
+  tracks = []
+  for _ in range(ntracks):
+    if data[pos:pos+4] != b"MTrk":
+      error(f"{path}: invalid track header")
+    tlen = struct.unpack(">I", data[pos+4:pos+8])[0]
+    end = pos + 8 + tlen
+    pos += 8
+    tick = 0
+    status = 0
+    notes = []
+    while pos < end:
+      delta, pos = read_varlen(data, pos)
+      tick += delta
+      if data[pos] & 0x80:
+        status = data[pos]
+        pos += 1
+      kind = status & 0xf0
+      if status == 0xff:
+        meta = data[pos]
+        mlen, pos = read_varlen(data, pos + 1)
+        if meta == 0x51:
+          tempos.append((tick, int.from_bytes(data[pos:pos+3], "big")))
+        pos += mlen
+      elif status in (0xf0, 0xf7):
+        slen, pos = read_varlen(data, pos)
+        pos += slen
+      elif kind in (0x80, 0x90):
+        note, vel = data[pos], data[pos+1]
+        pos += 2
+        notes.append((tick, note, kind == 0x90 and vel > 0))
+      elif kind in (0xc0, 0xd0):
+        pos += 1
+      else:
+        pos += 2
+    pos = end
+    tracks.append(notes)
+
+  if track_index is None:
+    track_index = next((i for i, t in enumerate(tracks) if t), None)
+    if track_index is None:
+      error(f"{path}: no notes found")
+  elif track_index >= len(tracks):
+    error(f"{path}: track {track_index} does not exist")
+
+  # Convert the MIDI ticks into rows, taking the tempo changes into account
+  tempos.sort()
+  def to_row(tick):
+    us = 0
+    last_tick, last_tempo = 0, tempos[0][1]
+    for t, tempo in tempos[1:]:
+      if t >= tick:
+        break
+      us += (t - last_tick) * last_tempo / division
+      last_tick, last_tempo = t, tempo
+    us += (tick - last_tick) * last_tempo / division
+    return round(us * TICKS_PER_SEC / (1000000 * speed))
+
+  # Pair the note-on and note-off events
+  pending = {}
+  spans = []
+  for tick, note, on in tracks[track_index]:
+    if note in pending:
+      start = pending.pop(note)
+      spans.append((to_row(start), to_row(tick), note))
+    if on:
+      pending[note] = tick
+  spans.sort()
+
+  # Allocate a voice for each note, drop the ones that don't fit
+  voices = [ Voice() for _ in range(SEQ_VOICES) ]
+  for start, end, note in spans:
+    end = max(end, start + 1)
+    divider = midi_to_divider(note)
+    voice = next((v for v in voices if v.rows <= start), None)
+    if voice is None or divider is None:
+      print(f"warning: dropping note {note} at row {start}", file=sys.stderr)
+      continue
+    voice.add_rest(start - voice.rows)
+    voice.add_note(divider, end - start)
+
+  return voices
+
+
+class Song:
+  def __init__(self, voices, rows):
+    self.rows = rows
+    self.notes = []
+    self.patterns = []
+    self.orders = []
+    total = max(v.rows for v in voices)
+    self.order_count = (total + rows - 1) // rows
+    # Silence each voice until the end of the last order
+    for v in voices:
+      if v.events:
+        v.add_rest(self.order_count * rows - v.rows)
+    columns = [ self.split(v) for v in voices ]
+    for i in range(self.order_count):
+      self.orders.append([ self.add_pattern(c[i]) if i < len(c) else SEQ_NO_PATTERN for c in columns ])
+
+  def note_index(self, divider):
+    if divider not in self.notes:
+      if len(self.notes) > SEQ_NOTE_MAX:
+        error("too many different notes")
+      self.notes.append(divider)
+    return self.notes.index(divider)
+
+  def add_pattern(self, data):
+    if data not in self.patterns:
+      self.patterns.append(data)
+    return self.patterns.index(data)
+
+  def split(self, voice):
+    """Encode the events of a voice and split them into patterns of `rows` rows"""
+    patterns = []
+    current = bytearray()
+    row = 0
+    length = None
+
+    def emit(event, rows):
+      nonlocal current, row, length
+      while rows > 0:
+        chunk = min(rows, self.rows - row, 255)
+        if chunk != length:
+          current += bytes([ SEQ_LENGTH, chunk ])
+          length = chunk
+        current.append(event)
+        # The remaining of the note continues in the next chunk
+        event = SEQ_WAIT if event <= SEQ_NOTE_MAX else event
+        rows -= chunk
+        row += chunk
+        if row == self.rows:
+          current.append(SEQ_END)
+          patterns.append(bytes(current))
+          current = bytearray()
+          row = 0
+
+    for event in voice.events:
+      if event[0] == "note":
+        emit(self.note_index(event[1]), event[2])
+      elif event[0] == "rest":
+        emit(SEQ_REST, event[1])
+      elif event[0] == "wave":
+        current += bytes([ SEQ_WAVE, event[1] ])
+      elif event[0] == "vol":
+        current += bytes([ SEQ_VOLUME, event[1] ])
+      elif event[0] == "inst":
+        current += bytes([ SEQ_INSTRUMENT, event[1] ])
+    return patterns
+
+  def serialize(self, speed, loop):
+    if self.order_count > 255 or len(self.patterns) > 255:
+      error("song too long, try increasing the number of rows per pattern")
+    header = SEQ_MAGIC + bytes([ SEQ_VERSION, speed, self.rows, self.order_count, loop,
+                                 len(self.notes), len(self.patterns) ])
+    notes = b"".join(struct.pack("<H", n) for n in self.notes)
+    orders = b"".join(bytes(o) for o in self.orders)
+    offset = len(header) + len(notes) + len(orders) + 2 * len(self.patterns)
+    offsets = b""
+    for p in self.patterns:
+      offsets += struct.pack("<H", offset)
+      offset += len(p)
+    return header + notes + orders + offsets + b"".join(self.patterns)
+
+
+def main():
+  args = parser.parse_args()
+  if not 1 <= args.speed <= 255:
+    error("speed must be between 1 and 255")
+  if not 1 <= args.rows <= 255:
+    error("rows must be between 1 and 255")
+
+  if Path(args.input).suffix.lower() in (".mid", ".midi"):
+    voices = parse_midi(args.input, args.speed, args.track)
+  else:
+    voices = parse_notes(args.input, args.speed)
+
+  if all(v.rows == 0 for v in voices):
+    error(f"{args.input}: no notes found")
+
+  song = Song(voices, args.rows)
+  loop = SEQ_NO_LOOP if args.loop is None else args.loop
+  if loop != SEQ_NO_LOOP and loop >= song.order_count:
+    error(f"loop entry must be smaller than {song.order_count}")
+  data = song.serialize(args.speed, loop)
+
+  output = args.output or Path(args.input).with_suffix(".zsq")
+  directory = os.path.dirname(output)
+  if directory:
+    os.makedirs(directory, exist_ok=True)
+  with open(output, "wb") as f:
+    f.write(data)
+
+  if args.verbose:
+    print(f"notes {len(song.notes)}, orders {song.order_count}, patterns {len(song.patterns)}")
+    print(f"{output}: {len(data)} bytes")
+
+
+if __name__ == "__main__":
+  main()
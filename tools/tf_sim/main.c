@@ -0,0 +1,233 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "zvb_tf.h"
+#include "sim_card.h"
+#include "sim_spi.h"
+
+/* Physical memory seen by `zvb_tf_read_phys`, wrapped around every HOST_PAGES pages */
+#define HOST_PAGE_SIZE  (16 * 1024)
+#define HOST_PAGES      8
+
+uint8_t* zvb_host_page0;
+static uint8_t s_memory[HOST_PAGES][HOST_PAGE_SIZE];
+
+static sim_card_t s_card;
+static uint8_t s_buffer[4 * TF_BLOCK_SIZE];
+static int s_failures;
+
+
+uint8_t* zvb_host_phys_page(uint8_t page)
+{
+    return s_memory[page % HOST_PAGES];
+}
+
+
+static void check(int condition, const char* name, const char* what)
+{
+    if (!condition) {
+        printf("FAIL %s: %s\n", name, what);
+        s_failures++;
+    }
+}
+
+
+/**
+ * @brief Power up a card of the given type, filled with a pattern that depends on each block index
+ */
+static void card_setup(uint8_t type, uint8_t init_polls)
+{
+    memset(&s_card, 0, sizeof(s_card));
+    s_card.type = type;
+    s_card.init_polls = init_polls;
+    for (int b = 0; b < SIM_BLOCKS; b++) {
+        for (int i = 0; i < SIM_BLOCK_SIZE; i++) {
+            s_card.data[b][i] = (uint8_t) (b * 31 + i * 7 + (i >> 8));
+        }
+    }
+    sim_card_reset(&s_card);
+    sim_spi_attach(&s_card);
+}
+
+
+static int card_init(uint8_t type, uint8_t init_polls, const char* name)
+{
+    card_setup(type, init_polls);
+    const tf_error err = zvb_tf_init();
+    check(err == TF_SUCCESS, name, "initialization failed");
+    check(zvb_tf_type() == type, name, "wrong card type");
+    return err == TF_SUCCESS;
+}
+
+
+static void test_crc7(void)
+{
+    /* CMD0 and CMD8 with the argument 0x1AA have well-known CRC bytes */
+    const uint8_t cmd0[] = { 0x40, 0x00, 0x00, 0x00, 0x00 };
+    const uint8_t cmd8[] = { 0x48, 0x00, 0x00, 0x01, 0xaa };
+    check(((sim_crc7(cmd0, 5) << 1) | 1) == 0x95, "crc7", "CMD0");
+    check(((sim_crc7(cmd8, 5) << 1) | 1) == 0x87, "crc7", "CMD8");
+    /* CRC16-CCITT (XModem) check value */
+    check(sim_crc16((const uint8_t*) "123456789", 9) == 0x31c3, "crc16", "check value");
+}
+
+
+static void test_no_card(void)
+{
+    sim_spi_attach(NULL);
+    check(zvb_tf_init() == TF_NO_CARD, "no card", "card detected");
+    check(zvb_tf_type() == TF_TYPE_NONE, "no card", "type set");
+}
+
+
+static void test_read(uint8_t type, const char* name)
+{
+    if (!card_init(type, 3, name)) {
+        return;
+    }
+    check(zvb_tf_read(5, s_buffer, 1) == TF_SUCCESS, name, "single block read");
+    check(memcmp(s_buffer, s_card.data[5], TF_BLOCK_SIZE) == 0, name, "single block content");
+    check(zvb_tf_read(10, s_buffer, 4) == TF_SUCCESS, name, "multiple block read");
+    check(memcmp(s_buffer, s_card.data[10], 4 * TF_BLOCK_SIZE) == 0, name, "multiple block content");
+    check(zvb_tf_read(SIM_BLOCKS, s_buffer, 1) != TF_SUCCESS, name, "out of range read");
+    /* The card must still answer after an error */
+    check(zvb_tf_read(0, s_buffer, 2) == TF_SUCCESS, name, "read after an error");
+    check(s_card.command_crc_errors == 0, name, "command CRC errors");
+}
+
+
+static void test_write(uint8_t type, const char* name)
+{
+    if (!card_init(type, 0, name)) {
+        return;
+    }
+    for (int i = 0; i < (int) sizeof(s_buffer); i++) {
+        s_buffer[i] = (uint8_t) (i ^ 0x5a);
+    }
+    check(zvb_tf_write(20, s_buffer, 1) == TF_SUCCESS, name, "single block write");
+    check(zvb_tf_write(30, s_buffer, 4) == TF_SUCCESS, name, "multiple block write");
+    check(s_card.blocks_written == 5, name, "blocks written");
+    check(memcmp(s_card.data[20], s_buffer, TF_BLOCK_SIZE) == 0, name, "single block content");
+    check(memcmp(s_card.data[30], s_buffer, 4 * TF_BLOCK_SIZE) == 0, name, "multiple block content");
+
+    memset(s_buffer, 0, sizeof(s_buffer));
+    check(zvb_tf_read(30, s_buffer, 4) == TF_SUCCESS, name, "read back");
+    check(memcmp(s_card.data[30], s_buffer, 4 * TF_BLOCK_SIZE) == 0, name, "read back content");
+    check(s_card.command_crc_errors == 0, name, "command CRC errors");
+}
+
+
+static void test_crc(void)
+{
+    const char* name = "crc";
+    if (!card_init(SIM_TYPE_SDHC, 0, name)) {
+        return;
+    }
+    check(zvb_tf_set_crc(1) == TF_SUCCESS, name, "enable");
+    check(s_card.crc_enabled, name, "card CRC check not enabled");
+
+    /* With the CRC enabled, all the commands and written blocks are checked by the card */
+    check(zvb_tf_read(1, s_buffer, 3) == TF_SUCCESS, name, "read");
+    check(memcmp(s_buffer, s_card.data[1], 3 * TF_BLOCK_SIZE) == 0, name, "read content");
+    memset(s_buffer, 0xa5, sizeof(s_buffer));
+    check(zvb_tf_write(40, s_buffer, 2) == TF_SUCCESS, name, "write");
+    check(memcmp(s_card.data[40], s_buffer, 2 * TF_BLOCK_SIZE) == 0, name, "write content");
+    check(s_card.command_crc_errors == 0, name, "command CRC errors");
+
+    /* Corrupted blocks are detected, in single and multiple block reads */
+    s_card.read_crc_errors = 1;
+    check(zvb_tf_read(2, s_buffer, 1) == TF_CRC_ERROR, name, "corrupted single block");
+    s_card.read_crc_errors = 1;
+    check(zvb_tf_read(2, s_buffer, 4) == TF_CRC_ERROR, name, "corrupted multiple block");
+    check(zvb_tf_read(2, s_buffer, 4) == TF_SUCCESS, name, "read after a CRC error");
+
+    /* Rejected blocks are reported */
+    s_card.write_crc_errors = 1;
+    check(zvb_tf_write(50, s_buffer, 1) == TF_CRC_ERROR, name, "rejected single block");
+    s_card.write_crc_errors = 1;
+    check(zvb_tf_write(50, s_buffer, 3) == TF_CRC_ERROR, name, "rejected multiple block");
+    check(zvb_tf_write(50, s_buffer, 3) == TF_SUCCESS, name, "write after a CRC error");
+
+    /* Without the CRC check, corrupted blocks go unnoticed */
+    check(zvb_tf_set_crc(0) == TF_SUCCESS, name, "disable");
+    check(!s_card.crc_enabled, name, "card CRC check not disabled");
+    s_card.read_crc_errors = 1;
+    check(zvb_tf_read(2, s_buffer, 1) == TF_SUCCESS, name, "unchecked corrupted block");
+    check(memcmp(s_buffer, s_card.data[2], TF_BLOCK_SIZE) != 0, name, "corruption not injected");
+    check(s_card.command_crc_errors == 0, name, "command CRC errors");
+}
+
+
+static void test_read_phys(void)
+{
+    const char* name = "read phys";
+    if (!card_init(SIM_TYPE_SDHC, 0, name)) {
+        return;
+    }
+    check(zvb_tf_set_crc(1) == TF_SUCCESS, name, "enable CRC");
+
+    /* Start 100 bytes before the end of page 5, the blocks cross a page boundary */
+    const uint32_t phys = 6UL * HOST_PAGE_SIZE - 100;
+    const uint8_t* memory = &s_memory[0][0];
+    memset(s_memory, 0, sizeof(s_memory));
+    check(zvb_tf_read_phys(60, phys, 3) == TF_SUCCESS, name, "read");
+    check(memcmp(memory + phys, s_card.data[60], 3 * TF_BLOCK_SIZE) == 0, name, "content");
+    check(memory[phys - 1] == 0 && memory[phys + 3 * TF_BLOCK_SIZE] == 0, name, "out of bounds write");
+    check(zvb_host_page0 == NULL, name, "page 0 not restored");
+
+    s_card.read_crc_errors = 1;
+    check(zvb_tf_read_phys(60, phys, 2) == TF_CRC_ERROR, name, "corrupted block");
+}
+
+
+static void test_negotiate(uint8_t min_clk_div, uint8_t expected, const char* name)
+{
+    uint8_t clk_div = 0;
+
+    if (!card_init(SIM_TYPE_SDHC, 0, name)) {
+        return;
+    }
+    s_card.min_clk_div = min_clk_div;
+    check(zvb_tf_negotiate_clock(7, s_buffer, &clk_div) == TF_SUCCESS, name, "negotiation failed");
+    if (clk_div != expected) {
+        printf("FAIL %s: divider %d, expected %d\n", name, clk_div, expected);
+        s_failures++;
+    }
+    check(zvb_spi_get_clk_div() == clk_div, name, "divider not applied");
+    check(!s_card.crc_enabled, name, "CRC check not restored");
+    check(zvb_tf_read(0, s_buffer, 4) == TF_SUCCESS, name, "read at the chosen divider");
+    check(memcmp(s_buffer, s_card.data[0], 4 * TF_BLOCK_SIZE) == 0, name, "content at the chosen divider");
+}
+
+
+int main(void)
+{
+    test_crc7();
+    test_no_card();
+    test_read(SIM_TYPE_SDHC, "read SDHC");
+    test_read(SIM_TYPE_SDV2, "read SDv2");
+    test_read(SIM_TYPE_SDV1, "read SDv1");
+    test_write(SIM_TYPE_SDHC, "write SDHC");
+    test_write(SIM_TYPE_SDV1, "write SDv1");
+    test_crc();
+    test_read_phys();
+    test_negotiate(0, SPI_CLK_DIV_MIN, "negotiate reliable");
+    test_negotiate(3, 3, "negotiate div 3");
+    /* Between the slow divider and 5MHz */
+    test_negotiate(8, 8, "negotiate div 8");
+    test_negotiate(20, 25, "negotiate div 25");
+    test_negotiate(SPI_CLK_DIV_SLOW, SPI_CLK_DIV_SLOW, "negotiate slow");
+
+    if (s_failures) {
+        printf("Self-test failed: %d error(s)\n", s_failures);
+        return 1;
+    }
+    printf("Self-test passed\n");
+    return 0;
+}
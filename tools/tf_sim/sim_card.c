@@ -0,0 +1,363 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "sim_card.h"
+
+/* R1 response bits */
+#define R1_IDLE             0x01
+#define R1_ILLEGAL_COMMAND  0x04
+#define R1_COM_CRC_ERROR    0x08
+#define R1_ADDRESS_ERROR    0x20
+#define R1_PARAMETER_ERROR  0x40
+
+#define TOKEN_START_BLOCK   0xfe
+#define TOKEN_START_MULTI   0xfc
+#define TOKEN_STOP_MULTI    0xfd
+
+/* Data response tokens */
+#define DATA_ACCEPTED       0x05
+#define DATA_CRC_ERROR      0x0b
+
+/* Number of bytes the card stays busy after a write or a stop command */
+#define SIM_BUSY_BYTES      24
+/* Number of bytes sent before the start token of a block, the access time */
+#define SIM_ACCESS_BYTES    3
+
+enum {
+    MODE_COMMAND,       // Waiting for a command
+    MODE_READ_MULTI,    // Streaming blocks until CMD12
+    MODE_WRITE_TOKEN,   // Waiting for the start token of a block to write
+    MODE_WRITE_DATA,    // Receiving a block and its CRC
+};
+
+
+uint8_t sim_crc7(const uint8_t* data, uint16_t length)
+{
+    uint8_t crc = 0;
+
+    for (uint16_t i = 0; i < length; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            const uint8_t in = (data[i] >> bit) & 1;
+            const uint8_t top = (crc >> 6) & 1;
+            crc = (crc << 1) & 0x7f;
+            if (in ^ top) {
+                crc ^= 0x09;
+            }
+        }
+    }
+    return crc;
+}
+
+
+uint16_t sim_crc16(const uint8_t* data, uint16_t length)
+{
+    uint16_t crc = 0;
+
+    for (uint16_t i = 0; i < length; i++) {
+        crc ^= data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+
+static void sim_card_push(sim_card_t* card, uint8_t byte)
+{
+    if (card->out_len < sizeof(card->out)) {
+        card->out[card->out_len++] = byte;
+    }
+}
+
+
+static void sim_card_flush(sim_card_t* card)
+{
+    card->out_rd = 0;
+    card->out_len = 0;
+}
+
+
+/**
+ * @brief Queue a block to send: the access time, the start token, the data and its CRC
+ */
+static void sim_card_push_block(sim_card_t* card)
+{
+    uint8_t data[SIM_BLOCK_SIZE];
+
+    memcpy(data, card->data[card->block % SIM_BLOCKS], SIM_BLOCK_SIZE);
+    const uint16_t crc = sim_crc16(data, SIM_BLOCK_SIZE);
+
+    if (card->read_crc_errors) {
+        card->read_crc_errors--;
+        data[card->blocks_read % SIM_BLOCK_SIZE] ^= 0x01;
+    } else if (card->clk_div < card->min_clk_div) {
+        data[(card->blocks_read * 7) % SIM_BLOCK_SIZE] ^= 0x10;
+    }
+
+    for (int i = 0; i < SIM_ACCESS_BYTES; i++) {
+        sim_card_push(card, 0xff);
+    }
+    sim_card_push(card, TOKEN_START_BLOCK);
+    for (int i = 0; i < SIM_BLOCK_SIZE; i++) {
+        sim_card_push(card, data[i]);
+    }
+    sim_card_push(card, crc >> 8);
+    sim_card_push(card, crc & 0xff);
+    card->block++;
+    card->blocks_read++;
+}
+
+
+/**
+ * @brief Get the index of the block addressed by the argument of a read or write command
+ *
+ * @return 0 if the address is valid, the R1 error bits else
+ */
+static uint8_t sim_card_address(sim_card_t* card, uint32_t arg)
+{
+    if (card->type != SIM_TYPE_SDHC) {
+        if (arg % SIM_BLOCK_SIZE) {
+            return R1_ADDRESS_ERROR;
+        }
+        arg /= SIM_BLOCK_SIZE;
+    }
+    if (arg >= SIM_BLOCKS) {
+        return R1_PARAMETER_ERROR;
+    }
+    card->block = arg;
+    return 0;
+}
+
+
+static void sim_card_command(sim_card_t* card)
+{
+    const uint8_t index = card->cmd[0] & 0x3f;
+    const uint32_t arg = ((uint32_t) card->cmd[1] << 24) | ((uint32_t) card->cmd[2] << 16) |
+                         ((uint32_t) card->cmd[3] << 8) | card->cmd[4];
+    const uint8_t app_cmd = card->app_cmd;
+    uint8_t r1 = card->idle ? R1_IDLE : 0;
+
+    card->commands++;
+    card->app_cmd = 0;
+    sim_card_flush(card);
+
+    /* CMD12 is sent while the card is streaming, it answers after a stuff byte */
+    if (index == 12) {
+        sim_card_push(card, 0xff);
+    }
+    /* Response time, the R1 comes after at least one byte */
+    sim_card_push(card, 0xff);
+
+    const uint8_t check_crc = card->crc_enabled || index == 0 || index == 8;
+    if (check_crc && (card->cmd[5] >> 1) != sim_crc7(card->cmd, 5)) {
+        card->command_crc_errors++;
+        sim_card_push(card, r1 | R1_COM_CRC_ERROR);
+        return;
+    }
+
+    switch (index) {
+        case 0:
+            card->idle = 1;
+            card->crc_enabled = 0;
+            card->init_left = card->init_polls;
+            card->mode = MODE_COMMAND;
+            sim_card_push(card, R1_IDLE);
+            return;
+        case 8:
+            if (card->type == SIM_TYPE_SDV1) {
+                sim_card_push(card, r1 | R1_ILLEGAL_COMMAND);
+                return;
+            }
+            sim_card_push(card, r1);
+            sim_card_push(card, 0x00);
+            sim_card_push(card, 0x00);
+            sim_card_push(card, (arg >> 8) & 0x0f);
+            sim_card_push(card, arg & 0xff);
+            return;
+        case 12:
+            card->mode = MODE_COMMAND;
+            sim_card_push(card, r1);
+            card->busy = SIM_BUSY_BYTES;
+            return;
+        case 16:
+            sim_card_push(card, arg == SIM_BLOCK_SIZE ? r1 : r1 | R1_PARAMETER_ERROR);
+            return;
+        case 55:
+            card->app_cmd = 1;
+            sim_card_push(card, r1);
+            return;
+        case 41:
+            if (!app_cmd) {
+                break;
+            }
+            if (card->init_left) {
+                card->init_left--;
+            } else {
+                card->idle = 0;
+            }
+            sim_card_push(card, card->idle ? R1_IDLE : 0);
+            return;
+        case 58:
+            sim_card_push(card, r1);
+            sim_card_push(card, 0x80 | (card->type == SIM_TYPE_SDHC && !card->idle ? 0x40 : 0));
+            sim_card_push(card, 0xff);
+            sim_card_push(card, 0x80);
+            sim_card_push(card, 0x00);
+            return;
+        case 59:
+            card->crc_enabled = arg & 1;
+            sim_card_push(card, r1);
+            return;
+        case 17:
+        case 18:
+        case 24:
+        case 25: {
+            if (card->idle) {
+                break;
+            }
+            const uint8_t err = sim_card_address(card, arg);
+            sim_card_push(card, r1 | err);
+            if (err) {
+                return;
+            }
+            if (index == 17) {
+                sim_card_push_block(card);
+            } else if (index == 18) {
+                card->mode = MODE_READ_MULTI;
+            } else {
+                card->mode = MODE_WRITE_TOKEN;
+                card->multiple = index == 25;
+            }
+            return;
+        }
+        default:
+            break;
+    }
+    sim_card_push(card, r1 | R1_ILLEGAL_COMMAND);
+}
+
+
+static void sim_card_receive(sim_card_t* card, uint8_t mosi)
+{
+    card->rx[card->rx_len++] = mosi;
+    if (card->rx_len < sizeof(card->rx)) {
+        return;
+    }
+
+    const uint16_t crc = (card->rx[SIM_BLOCK_SIZE] << 8) | card->rx[SIM_BLOCK_SIZE + 1];
+    uint8_t response = DATA_ACCEPTED;
+
+    if (card->write_crc_errors) {
+        card->write_crc_errors--;
+        response = DATA_CRC_ERROR;
+    } else if (card->crc_enabled && crc != sim_crc16(card->rx, SIM_BLOCK_SIZE)) {
+        response = DATA_CRC_ERROR;
+    }
+
+    sim_card_flush(card);
+    sim_card_push(card, 0xe0 | response);
+    if (response == DATA_ACCEPTED) {
+        memcpy(card->data[card->block % SIM_BLOCKS], card->rx, SIM_BLOCK_SIZE);
+        card->block++;
+        card->blocks_written++;
+        card->busy = SIM_BUSY_BYTES;
+    }
+    /* A multiple block write continues until the stop token, even after an error */
+    card->mode = card->multiple ? MODE_WRITE_TOKEN : MODE_COMMAND;
+}
+
+
+void sim_card_reset(sim_card_t* card)
+{
+    card->selected = 0;
+    card->idle = 1;
+    card->app_cmd = 0;
+    card->crc_enabled = 0;
+    card->init_left = card->init_polls;
+    card->mode = MODE_COMMAND;
+    card->busy = 0;
+    card->cmd_len = 0;
+    card->rx_len = 0;
+    sim_card_flush(card);
+}
+
+
+void sim_card_select(sim_card_t* card, uint8_t selected)
+{
+    card->selected = selected;
+    /* The card drops the pending response bytes and the partial commands when released */
+    if (!selected) {
+        card->cmd_len = 0;
+        sim_card_flush(card);
+        if (card->mode == MODE_READ_MULTI) {
+            card->mode = MODE_COMMAND;
+        }
+    }
+}
+
+
+void sim_card_set_clk_div(sim_card_t* card, uint8_t clk_div)
+{
+    card->clk_div = clk_div;
+}
+
+
+uint8_t sim_card_exchange(sim_card_t* card, uint8_t mosi)
+{
+    uint8_t miso = 0xff;
+
+    if (!card->selected) {
+        return miso;
+    }
+
+    /* Output first, the card sends its byte while receiving the host one */
+    if (card->out_rd < card->out_len) {
+        miso = card->out[card->out_rd++];
+    } else if (card->busy) {
+        card->busy--;
+        miso = 0x00;
+    } else if (card->mode == MODE_READ_MULTI) {
+        sim_card_flush(card);
+        sim_card_push_block(card);
+        miso = card->out[card->out_rd++];
+    }
+
+    switch (card->mode) {
+        case MODE_WRITE_TOKEN:
+            if (mosi == TOKEN_START_BLOCK || mosi == TOKEN_START_MULTI) {
+                card->mode = MODE_WRITE_DATA;
+                card->rx_len = 0;
+            } else if (mosi == TOKEN_STOP_MULTI && card->multiple) {
+                card->mode = MODE_COMMAND;
+                /* The card is busy after the byte following the stop token */
+                sim_card_flush(card);
+                sim_card_push(card, 0xff);
+                card->busy = SIM_BUSY_BYTES;
+            } else if ((mosi & 0xc0) == 0x40 || card->cmd_len) {
+                /* Commands are still accepted, for example CMD12 to abort */
+                break;
+            }
+            return miso;
+        case MODE_WRITE_DATA:
+            sim_card_receive(card, mosi);
+            return miso;
+        default:
+            break;
+    }
+
+    /* Commands start with the bits 01, the host sends 0xff otherwise */
+    if (card->cmd_len || (mosi & 0xc0) == 0x40) {
+        card->cmd[card->cmd_len++] = mosi;
+        if (card->cmd_len == sizeof(card->cmd)) {
+            card->cmd_len = 0;
+            sim_card_command(card);
+        }
+    }
+    return miso;
+}
@@ -0,0 +1,99 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Simulated TF card, answering the SPI mode commands used by the `zvb_tf` driver:
+ *        CMD0, CMD8, CMD12, CMD16, CMD17, CMD18, CMD24, CMD25, CMD55/ACMD41, CMD58 and CMD59.
+ *        The card is driven one byte at a time by `sim_card_exchange`, like on the SPI bus.
+ *
+ *        The CRC7 of CMD0 and CMD8 is always checked, the CRC of the other commands and of the
+ *        written blocks only once enabled with CMD59. Errors can be injected in the blocks read
+ *        and written, and the card can be made unreliable above a given SPI clock.
+ */
+
+#define SIM_BLOCK_SIZE      512
+#define SIM_BLOCKS          128
+
+/* Same values as TF_TYPE_* */
+#define SIM_TYPE_SDV1       1
+#define SIM_TYPE_SDV2       2
+#define SIM_TYPE_SDHC       3
+
+typedef struct {
+    /* Configuration, set before calling `sim_card_reset` */
+    uint8_t  type;
+    /* Number of ACMD41 commands answered with the idle bit before the card is ready */
+    uint8_t  init_polls;
+    /* The blocks read at a clock divider below this one have a bit flipped after their CRC
+     * was calculated, 0 to always send correct blocks */
+    uint8_t  min_clk_div;
+
+    /* Error injection, decremented each time an error is injected */
+    uint16_t read_crc_errors;   // Next blocks read are corrupted after their CRC is calculated
+    uint16_t write_crc_errors;  // Next blocks written are rejected with a CRC error response
+
+    /* Statistics */
+    uint32_t commands;
+    uint32_t command_crc_errors;
+    uint32_t blocks_read;
+    uint32_t blocks_written;
+
+    uint8_t  data[SIM_BLOCKS][SIM_BLOCK_SIZE];
+
+    /* Internal state */
+    uint8_t  selected;
+    uint8_t  idle;
+    uint8_t  app_cmd;
+    uint8_t  crc_enabled;
+    uint8_t  clk_div;
+    uint8_t  init_left;
+    uint8_t  mode;
+    uint8_t  multiple;          // The write in progress is a multiple block write
+    uint32_t block;             // Next block to stream or to write
+    uint16_t busy;              // Number of busy bytes to send after a write
+    uint8_t  cmd[6];
+    uint8_t  cmd_len;
+    uint8_t  rx[SIM_BLOCK_SIZE + 2];
+    uint16_t rx_len;
+    uint8_t  out[SIM_BLOCK_SIZE + 16];
+    uint16_t out_rd;
+    uint16_t out_len;
+} sim_card_t;
+
+
+/**
+ * @brief Power the card up: it waits for CMD0, with the CRC check disabled
+ */
+void sim_card_reset(sim_card_t* card);
+
+
+/**
+ * @brief Assert (1) or release (0) the chip select of the card
+ */
+void sim_card_select(sim_card_t* card, uint8_t selected);
+
+
+/**
+ * @brief Set the clock divider the bytes are exchanged at, see `min_clk_div`
+ */
+void sim_card_set_clk_div(sim_card_t* card, uint8_t clk_div);
+
+
+/**
+ * @brief Exchange a byte with the card: the host sends `mosi` while the card sends the returned byte
+ */
+uint8_t sim_card_exchange(sim_card_t* card, uint8_t mosi);
+
+
+/**
+ * @brief Reference CRC7 of a command and CRC16-CCITT of a data block, as specified by the SD standard
+ */
+uint8_t sim_crc7(const uint8_t* data, uint16_t length);
+uint16_t sim_crc16(const uint8_t* data, uint16_t length);
@@ -0,0 +1,101 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "zvb_spi.h"
+#include "sim_spi.h"
+
+/**
+ * @brief Host implementation of the SPI library: every byte goes through `sim_card_exchange`,
+ *        this is the only link between the `zvb_tf` driver and the simulated card.
+ */
+
+static sim_card_t* s_card;
+static uint8_t s_clk_div;
+static uint32_t s_bytes;
+
+
+void sim_spi_attach(sim_card_t* card)
+{
+    s_card = card;
+    s_bytes = 0;
+}
+
+
+uint32_t sim_spi_bytes(void)
+{
+    return s_bytes;
+}
+
+
+void zvb_spi_initialize(uint8_t clk_div)
+{
+    zvb_spi_set_clk_div(clk_div);
+    zvb_spi_deselect();
+}
+
+
+void zvb_spi_set_clk_div(uint8_t clk_div)
+{
+    s_clk_div = clk_div;
+    if (s_card) {
+        sim_card_set_clk_div(s_card, clk_div);
+    }
+}
+
+
+uint8_t zvb_spi_get_clk_div(void)
+{
+    return s_clk_div;
+}
+
+
+void zvb_spi_select(uint8_t cs)
+{
+    if (s_card) {
+        sim_card_select(s_card, cs == SPI_CS_TF);
+    }
+}
+
+
+void zvb_spi_deselect(void)
+{
+    if (s_card) {
+        sim_card_select(s_card, 0);
+    }
+}
+
+
+uint8_t zvb_spi_byte(uint8_t value)
+{
+    s_bytes++;
+    /* Without a card, the MISO line is pulled up */
+    return s_card ? sim_card_exchange(s_card, value) : 0xff;
+}
+
+
+void zvb_spi_transfer(const uint8_t* tx, uint8_t* rx, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        rx[i] = zvb_spi_byte(tx[i]);
+    }
+}
+
+
+void zvb_spi_send(const uint8_t* tx, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        zvb_spi_byte(tx[i]);
+    }
+}
+
+
+void zvb_spi_receive(uint8_t* rx, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        rx[i] = zvb_spi_byte(SPI_FILL_BYTE);
+    }
+}
@@ -0,0 +1,22 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "sim_card.h"
+
+
+/**
+ * @brief Connect the simulated card to the host SPI controller, NULL to remove it
+ */
+void sim_spi_attach(sim_card_t* card);
+
+
+/**
+ * @brief Get the number of bytes exchanged on the bus since the card was attached
+ */
+uint32_t sim_spi_bytes(void);
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import os
+import struct
+import sys
+from pathlib import Path
+
+import numpy as np
+from PIL import Image, ImageSequence
+
+# Must be kept in sync with `examples/tf_video/src/video.h`
+VIDEO_MAGIC       = b"ZTV"
+VIDEO_VERSION     = 1
+VIDEO_MODE        = 5   # ZVB_CTRL_VID_MODE_GFX_320_8BIT
+BLOCK_SIZE        = 512
+COLS              = 20
+ROWS              = 15
+TILE_WIDTH        = 16
+TILE_SIZE         = TILE_WIDTH * TILE_WIDTH
+TILES             = 256
+PAIRS             = TILES // 2
+FRAME_HEADER_SIZE = 4 + COLS * ROWS
+MAX_RUNS          = (BLOCK_SIZE - FRAME_HEADER_SIZE) // 2
+VBLANKS           = 60
+
+parser = argparse.ArgumentParser("video2zeal")
+parser.add_argument("-i", "--input", help="Animated GIF, or frames in alphabetical order", nargs="+", required=True)
+parser.add_argument("-o", "--output", help="Output stream, defaults to the first input with a .ztv extension")
+parser.add_argument("-f", "--fps", help="Frames per second, must be a divisor of 60", type=int, default=10)
+parser.add_argument("-s", "--skip", help="Only keep one frame out of N from the input", type=int, default=1)
+parser.add_argument("-t", "--threshold", help="Reuse a tile already in VRAM when its mean squared error is below this value", type=float, default=0.0)
+parser.add_argument("-m", "--max-tiles", help="Maximum number of different tiles per frame", type=int, default=160)
+parser.add_argument("--dither", help="Dither the frames when reducing them to the palette", action="store_true")
+parser.add_argument("--preview", help="Also write the frames as decoded by Zeal 8-bit Computer to this GIF")
+parser.add_argument("-v", "--verbose", help="Verbose output", action='store_true')
+
+
+def error(msg):
+  print(f"error: {msg}", file=sys.stderr)
+  sys.exit(1)
+
+
+def load_frames(inputs, skip):
+  """Return all the frames as RGB images of the screen size"""
+  frames = []
+  for path in inputs:
+    try:
+      with Image.open(path) as img:
+        for frame in ImageSequence.Iterator(img):
+          frames.append(frame.convert("RGB").resize((COLS * TILE_WIDTH, ROWS * TILE_WIDTH), Image.LANCZOS))
+    except OSError as e:
+      error(f"{path}: {e}")
+  return frames[::skip]
+
+
+def make_palette(frames):
+  """Quantize a sample of the frames at once, to get a single palette for the whole video"""
+  step = max(1, len(frames) // 64)
+  sample = frames[::step]
+  width, height = sample[0].size
+  mosaic = Image.new("RGB", (width, height * len(sample)))
+  for i, frame in enumerate(sample):
+    mosaic.paste(frame, (0, i * height))
+  return mosaic.quantize(colors=256, method=Image.Quantize.MEDIANCUT)
+
+
+def palette_rgb565(palette_img):
+  colors = palette_img.getpalette()[:768]
+  colors += [0] * (768 - len(colors))
+  data = bytearray()
+  for i in range(0, 768, 3):
+    r, g, b = colors[i:i+3]
+    data += struct.pack("<H", ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+  return bytes(data), np.array(colors, dtype=np.int32).reshape(256, 3)
+
+
+def split_tiles(indexed):
+  """Split an indexed frame into its tiles, row by row, each tile being 256 bytes"""
+  pixels = np.array(indexed, dtype=np.uint8)
+  tiles = pixels.reshape(ROWS, TILE_WIDTH, COLS, TILE_WIDTH).swapaxes(1, 2)
+  return [ tiles[r, c].tobytes() for r in range(ROWS) for c in range(COLS) ]
+
+
+class Encoder:
+  """
+  Models the tileset in VRAM. The new tiles of a frame are written while the previous frame is
+  shown, so they must only replace tiles that neither frame uses. Tiles are allocated by pairs,
+  a pair being a single block on the card. Pair 0 is reserved, tile 0 stays transparent.
+  """
+  def __init__(self, colors, threshold, max_tiles):
+    self.colors = colors
+    self.threshold = threshold
+    self.max_tiles = max_tiles
+    self.cache = {}
+    self.slots = [ bytes(TILE_SIZE) ] + [ None ] * (TILES - 1)
+    self.last_use = [ 0 ] * PAIRS
+    self.shown = set()
+    self.merged = 0
+
+  def rgb(self, tile):
+    if tile not in self.cache:
+      self.cache[tile] = self.colors[np.frombuffer(tile, dtype=np.uint8)].astype(np.float32)
+    return self.cache[tile]
+
+  def closest(self, tile, candidates):
+    """Return the candidate closest to the given tile and its mean squared error"""
+    candidates = list(candidates)
+    errors = np.mean((np.stack([ self.rgb(c) for c in candidates ]) - self.rgb(tile)) ** 2, axis=(1, 2))
+    best = int(np.argmin(errors))
+    return candidates[best], float(errors[best])
+
+  def encode(self, index, tiles):
+    resident = { content: slot for slot, content in enumerate(self.slots) if content is not None }
+    # Approximate matches with the tiles already in VRAM
+    if self.threshold > 0:
+      tiles = [ t if t in resident else self.approximate(t, resident) for t in tiles ]
+    keep = { resident[t] for t in tiles if t in resident }
+    busy = self.shown | keep
+    free = [ p for p in range(1, PAIRS) if 2 * p not in busy and 2 * p + 1 not in busy ]
+    new = list(dict.fromkeys(t for t in tiles if t not in resident))
+
+    # Not enough room: replace the least used new tiles with the closest ones until they fit.
+    # The tiles of the frame shown can be used too, they won't be overwritten. Limiting the number
+    # of tiles per frame keeps room for the next one.
+    while new and (len(new) > 2 * len(free) or len(set(tiles)) > self.max_tiles):
+      victim = min(new, key=lambda t: tiles.count(t))
+      new.remove(victim)
+      candidates = new + [ self.slots[s] for s in busy | { 0 } if self.slots[s] is not None ]
+      target, _ = self.closest(victim, candidates)
+      tiles = [ target if t == victim else t for t in tiles ]
+      self.merged += 1
+
+    # Use the least recently used pairs, then group the consecutive ones in runs
+    count = (len(new) + 1) // 2
+    pairs = sorted(sorted(free, key=lambda p: self.last_use[p])[:count])
+    runs = self.make_runs(pairs)
+    if len(runs) > MAX_RUNS:
+      pairs = free[:count]
+      runs = self.make_runs(pairs)
+
+    data = bytearray()
+    for i, pair in enumerate(pairs):
+      first = new[2 * i]
+      second = new[2 * i + 1] if 2 * i + 1 < len(new) else None
+      self.slots[2 * pair] = first
+      self.slots[2 * pair + 1] = second
+      data += first + (second or first)
+    for content in tiles:
+      resident_slot = self.slots.index(content)
+      self.last_use[resident_slot // 2] = index
+    tilemap = bytes(self.slots.index(t) for t in tiles)
+    self.shown = set(tilemap)
+
+    header = struct.pack("<HBB", 1 + len(pairs), len(runs), 0) + tilemap
+    header += b"".join(struct.pack("BB", first, count) for first, count in runs)
+    header += bytes(BLOCK_SIZE - len(header))
+    return header + data, tilemap
+
+  def approximate(self, tile, resident):
+    target, mse = self.closest(tile, resident.keys())
+    return target if mse <= self.threshold else tile
+
+  @staticmethod
+  def make_runs(pairs):
+    runs = []
+    for pair in pairs:
+      if runs and runs[-1][0] + runs[-1][1] == pair:
+        runs[-1][1] += 1
+      else:
+        runs.append([pair, 1])
+    return runs
+
+
+def main():
+  args = parser.parse_args()
+  if args.fps <= 0 or VBLANKS % args.fps != 0:
+    error("fps must be a divisor of 60")
+  if args.skip <= 0:
+    error("skip must be positive")
+  if not 1 <= args.max_tiles <= TILES - 2:
+    error(f"max-tiles must be between 1 and {TILES - 2}")
+
+  frames = load_frames(sorted(args.input) if len(args.input) > 1 else args.input, args.skip)
+  if not frames:
+    error("no frame to encode")
+  if len(frames) > 0xffff:
+    error(f"too many frames, {len(frames)}, at most 65535 are supported")
+
+  palette_img = make_palette(frames)
+  palette, colors = palette_rgb565(palette_img)
+  dither = Image.Dither.FLOYDSTEINBERG if args.dither else Image.Dither.NONE
+  encoder = Encoder(colors, args.threshold, args.max_tiles)
+
+  body = bytearray()
+  preview = []
+  largest = 0
+  for i, frame in enumerate(frames):
+    indexed = frame.quantize(palette=palette_img, dither=dither)
+    data, tilemap = encoder.encode(i + 1, split_tiles(indexed))
+    body += data
+    largest = max(largest, len(data) // BLOCK_SIZE)
+    if args.preview:
+      preview.append(render(encoder, tilemap, palette_img))
+
+  blocks = 2 + len(body) // BLOCK_SIZE
+  header = VIDEO_MAGIC + struct.pack("<BBBBBHI", VIDEO_VERSION, args.fps, VIDEO_MODE, COLS, ROWS, len(frames), blocks)
+  header += bytes(BLOCK_SIZE - len(header))
+
+  output = args.output or Path(args.input[0]).with_suffix(".ztv")
+  directory = os.path.dirname(output)
+  if directory:
+    os.makedirs(directory, exist_ok=True)
+  with open(output, "wb") as f:
+    f.write(header + palette + body)
+
+  if args.preview:
+    preview[0].save(args.preview, save_all=True, append_images=preview[1:], duration=1000 // args.fps, loop=0)
+
+  if args.verbose:
+    average = (blocks - 2) / len(frames)
+    print(f"{len(frames)} frames at {args.fps}fps, {len(frames) / args.fps:.2f}s")
+    print(f"{average:.1f} blocks per frame on average, {largest} at most, {encoder.merged} tiles merged")
+    print(f"Required bandwidth: {average * BLOCK_SIZE * args.fps / 1024:.0f}KB/s on average, "
+          f"{largest * BLOCK_SIZE * args.fps / 1024:.0f}KB/s at most")
+    print(f"{output}: {blocks} blocks")
+
+
+def render(encoder, tilemap, palette_img):
+  """Render a frame from the tileset model, exactly as the video board shows it"""
+  pixels = np.zeros((ROWS * TILE_WIDTH, COLS * TILE_WIDTH), dtype=np.uint8)
+  for i, slot in enumerate(tilemap):
+    r, c = divmod(i, COLS)
+    tile = np.frombuffer(encoder.slots[slot], dtype=np.uint8).reshape(TILE_WIDTH, TILE_WIDTH)
+    pixels[r*TILE_WIDTH:(r+1)*TILE_WIDTH, c*TILE_WIDTH:(c+1)*TILE_WIDTH] = tile
+  img = Image.fromarray(pixels, "P")
+  img.putpalette(palette_img.getpalette())
+  return img.convert("RGB")
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+
+# SPDX-FileCopyrightText: 2025 Zeal 8-bit Computer <contact@zeal8bit.com>
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import os
+import struct
+import sys
+import wave
+from pathlib import Path
+
+# Must be kept in sync with `include/zvb_sound_adpcm.h`
+ADPCM_MAGIC     = b"ZAD"
+ADPCM_VERSION   = 1
+ADPCM_MAX_BYTES = 0xffff
+SOUND_CLOCK     = 44091
+
+STEPS = [
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+  19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+  130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+  337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+  876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+  2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+  5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+INDEX_ADJUST = [ -1, -1, -1, -1, 2, 4, 6, 8 ]
+
+parser = argparse.ArgumentParser("wav2adpcm")
+parser.add_argument("-i", "--input", help="Input WAV file, 8-bit or 16-bit PCM", required=True)
+parser.add_argument("-o", "--output", help="Output file, defaults to the input with a .zad extension")
+parser.add_argument("-d", "--divider", help="Sample rate divider, the rate is 44091 / (divider + 1)", type=int, default=3)
+parser.add_argument("-g", "--gain", help="Gain to apply to the samples", type=float, default=1.0)
+parser.add_argument("--decode", help="Also write the decoded clip to this WAV file, to check the quality")
+parser.add_argument("-v", "--verbose", help="Verbose output", action='store_true')
+
+
+def error(msg):
+  print(f"error: {msg}", file=sys.stderr)
+  sys.exit(1)
+
+
+def read_wav(path):
+  """Return the samples of a WAV file as signed 16-bit mono values and its sample rate"""
+  try:
+    with wave.open(path, "rb") as w:
+      channels = w.getnchannels()
+      width = w.getsampwidth()
+      rate = w.getframerate()
+      frames = w.readframes(w.getnframes())
+  except (wave.Error, EOFError) as e:
+    error(f"{path}: {e}")
+
+  if width == 1:
+    values = [ (b - 128) << 8 for b in frames ]
+  elif width == 2:
+    values = list(struct.unpack(f"<{len(frames) // 2}h", frames))
+  else:
+    error(f"{path}: only 8-bit and 16-bit samples are supported")
+
+  # Mix all the channels down to mono
+  if channels > 1:
+    values = [ sum(values[i:i+channels]) // channels for i in range(0, len(values), channels) ]
+  return values, rate
+
+
+def resample(values, src_rate, dst_rate, gain):
+  """Linear interpolation, good enough for the target sample rates"""
+  count = int(len(values) * dst_rate / src_rate)
+  ratio = src_rate / dst_rate
+  out = []
+  for i in range(count):
+    pos = i * ratio
+    j = int(pos)
+    frac = pos - j
+    a = values[j]
+    b = values[min(j + 1, len(values) - 1)]
+    value = int((a + (b - a) * frac) * gain)
+    out.append(max(-32768, min(32767, value)))
+  return out
+
+
+class Decoder:
+  """Exact model of the Z80 decoder, the predictor is stored as an unsigned 16-bit value"""
+  def __init__(self, predictor, index):
+    self.predictor = predictor
+    self.index = index
+
+  def decode(self, nibble):
+    step = STEPS[self.index]
+    diff = step >> 3
+    if nibble & 4: diff += step
+    if nibble & 2: diff += step >> 1
+    if nibble & 1: diff += step >> 2
+    if nibble & 8:
+      self.predictor = max(0, self.predictor - diff)
+    else:
+      self.predictor = min(0xffff, self.predictor + diff)
+    self.index = max(0, min(88, self.index + INDEX_ADJUST[nibble & 7]))
+    return self.predictor >> 8
+
+
+def encode(samples):
+  """Encode the signed 16-bit samples, return the initial state, the data and the decoded samples"""
+  predictor = samples[0] + 0x8000 if samples else 0x8000
+  index = 0
+  decoder = Decoder(predictor, index)
+  nibbles = []
+  decoded = []
+  for sample in samples:
+    target = sample + 0x8000
+    delta = target - decoder.predictor
+    nibble = 0
+    if delta < 0:
+      nibble = 8
+      delta = -delta
+    step = STEPS[decoder.index]
+    if delta >= step:
+      nibble |= 4
+      delta -= step
+    if delta >= step >> 1:
+      nibble |= 2
+      delta -= step >> 1
+    if delta >= step >> 2:
+      nibble |= 1
+    nibbles.append(nibble)
+    decoded.append(decoder.decode(nibble))
+
+  if len(nibbles) & 1:
+    # Pad with a nibble that doesn't change the predictor much
+    nibbles.append(0)
+    decoded.append(decoder.decode(0))
+
+  data = bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, len(nibbles), 2))
+  return predictor, index, data, decoded
+
+
+def main():
+  args = parser.parse_args()
+  if not 0 <= args.divider <= 255:
+    error("divider must be between 0 and 255")
+
+  values, rate = read_wav(args.input)
+  dst_rate = SOUND_CLOCK / (args.divider + 1)
+  samples = resample(values, rate, dst_rate, args.gain)
+  predictor, index, data, decoded = encode(samples)
+
+  if len(data) > ADPCM_MAX_BYTES:
+    error(f"clip too long, {len(data)} bytes of data, at most {ADPCM_MAX_BYTES} are supported")
+
+  header = ADPCM_MAGIC + struct.pack("<BBBHH", ADPCM_VERSION, args.divider, index, predictor, len(data))
+
+  output = args.output or Path(args.input).with_suffix(".zad")
+  directory = os.path.dirname(output)
+  if directory:
+    os.makedirs(directory, exist_ok=True)
+  with open(output, "wb") as f:
+    f.write(header + data)
+
+  if args.decode:
+    with wave.open(args.decode, "wb") as w:
+      w.setnchannels(1)
+      w.setsampwidth(1)
+      w.setframerate(round(dst_rate))
+      w.writeframes(bytes(decoded))
+
+  if args.verbose:
+    print(f"{len(samples)} samples at {dst_rate:.0f}Hz, {len(samples) / dst_rate:.2f}s")
+    print(f"{output}: {len(header) + len(data)} bytes")
+
+
+if __name__ == "__main__":
+  main()